@@ -0,0 +1,113 @@
+/**
+ * @file Analytic_Lookback.cpp
+ * @brief Implementation of the Goldman–Sosin–Gatto floating-strike formulas.
+ */
+
+#include "Analytic_Lookback.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /// Below this rate the sigma^2/(2r) term is interpolated towards its r = 0 limit.
+    constexpr double kSmallRate = 1e-4;
+
+    double norm_cdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+    double norm_pdf(double x) { return std::exp(-0.5 * x * x) / std::sqrt(2.0 * M_PI); }
+
+    /**
+     * Reflection term sigma^2/(2r) * S [N(-x) - e^{-rT} (E/S)^{2r/sigma^2} N(-y)], where
+     * x, y are a1, a3 (call) or b2, b3 (put). `dir` is +1 for the call, -1 for the put.
+     */
+    double reflection_term(double dir, double S, double E, double sigma, double r, double T)
+    {
+        const double v = sigma * std::sqrt(T);
+        const double l = std::log(S / E);
+        const double s2 = sigma * sigma;
+
+        auto direct = [&](double rate) {
+            const double x = dir * (l + (rate + 0.5*s2)*T) / v;
+            const double y = dir * (l + (-rate + 0.5*s2)*T) / v;
+            const double bracket = norm_cdf(-x) - std::exp(-rate*T + 2.0*rate/s2 * std::log(E / S)) * norm_cdf(-y);
+            return s2 / (2.0*rate) * S * bracket;
+        };
+
+        if (r >= kSmallRate)
+            return direct(r);
+
+        // r -> 0 limit: (sigma^2/2) d/dr of the bracket at r = 0
+        const double a = dir * (l + 0.5*s2*T) / v;
+        const double limit = 0.5 * s2 * S * (-2.0 * dir * norm_pdf(a) * std::sqrt(T) / sigma
+                                             + (T - 2.0 * std::log(E / S) / s2) * norm_cdf(-a));
+        // linear in r between the limit and a well-conditioned direct evaluation
+        return limit + (direct(kSmallRate) - limit) * (r / kSmallRate);
+    }
+}
+
+double gsg_floating_strike_price(char option, double S, double extremum, double sigma, double interest_rate, double ttm)
+{
+    const bool call = (option == 'c' || option == 'C');
+    const double E = call ? std::min(extremum, S) : std::max(extremum, S);
+
+    if (ttm <= 0)
+        return call ? S - E : E - S;
+
+    const double v = sigma * std::sqrt(ttm);
+    const double df = std::exp(-interest_rate * ttm);
+
+    if (call)
+    {
+        const double a1 = (std::log(S / E) + (interest_rate + 0.5*sigma*sigma)*ttm) / v;
+        const double a2 = a1 - v;
+        return S * norm_cdf(a1) - E * df * norm_cdf(a2)
+             - reflection_term(1.0, S, E, sigma, interest_rate, ttm);
+    }
+
+    const double b1 = (std::log(E / S) + (-interest_rate + 0.5*sigma*sigma)*ttm) / v;
+    const double b2 = b1 - v;
+    return E * df * norm_cdf(b1) - S * norm_cdf(b2)
+         + reflection_term(-1.0, S, E, sigma, interest_rate, ttm);
+}
+
+risk_line gsg_floating_strike_risk(char option, double S, double extremum, double sigma, double interest_rate,
+                                   double ttm, bool extremum_tracks_spot)
+{
+    auto P = [&](double s, double e, double v, double r, double t) {
+        return gsg_floating_strike_price(option, s, e, v, r, t);
+    };
+
+    risk_line out{};
+    out.price = P(S, extremum, sigma, interest_rate, ttm);
+
+    if (extremum_tracks_spot)
+    {
+        out.delta = out.price / S;
+        out.gamma = 0.0;
+    }
+    else
+    {
+        const double dS = 1e-4 * S;
+        const double up = P(S + dS, extremum, sigma, interest_rate, ttm);
+        const double down = P(S - dS, extremum, sigma, interest_rate, ttm);
+        out.delta = (up - down) / (2.0 * dS);
+        out.gamma = (up + down - 2.0 * out.price) / (dS * dS);
+    }
+
+    const double e_up = extremum_tracks_spot ? S : extremum;
+    const double dv = 1e-5 * std::max(1.0, sigma);
+    out.vega = 0.01 * (P(S, e_up, sigma + dv, interest_rate, ttm) - P(S, e_up, sigma - dv, interest_rate, ttm)) / (2.0 * dv);
+
+    // the closed form extends smoothly to slightly negative rates, so the stencil can straddle r = 0
+    const double dr = 1e-5;
+    out.rho = 0.01 * (P(S, e_up, sigma, interest_rate + dr, ttm) - P(S, e_up, sigma, interest_rate - dr, ttm)) / (2.0 * dr);
+
+    const double dt = std::min(1e-5, 0.5 * ttm);
+    if (dt > 0)
+        out.theta = -(P(S, e_up, sigma, interest_rate, ttm + dt) - P(S, e_up, sigma, interest_rate, ttm - dt)) / (2.0 * dt);
+    else
+        out.theta = -(P(S, e_up, sigma, interest_rate, 1e-5) - out.price) / 1e-5;
+
+    out.price_se = 0.0;
+    return out;
+}
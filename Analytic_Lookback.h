@@ -0,0 +1,52 @@
+/**
+ * @file Analytic_Lookback.h
+ * @brief Closed-form prices of continuously monitored floating-strike lookback options.
+ *
+ * @details
+ * Goldman, Sosin and Gatto (1979) give the price of floating-strike lookbacks under
+ * Black–Scholes dynamics with constant volatility and rate (no dividends):
+ * - call, payoff \f$S_T - \min(m, \min_{t \le T} S_t)\f$,
+ * - put,  payoff \f$\max(M, \max_{t \le T} S_t) - S_T\f$,
+ * where \f$m \le S\f$ (resp. \f$M \ge S\f$) is the extremum already observed. A newly
+ * issued contract has \f$m = M = S\f$.
+ *
+ * The formula contains a term \f$\sigma^2/(2r)\f$ multiplying a bracket that vanishes
+ * at \f$r = 0\f$; the limit is evaluated analytically, so \f$r = 0\f$ is supported.
+ *
+ * These prices back the analytic engine of `look_back` (see pricing_engine) and are the
+ * reference of the accuracy harness (tools/accuracy_harness.cpp).
+ */
+
+#ifndef Analytic_Lookback_h
+#define Analytic_Lookback_h
+
+#include "Look_Back.h"
+
+/**
+ * @brief Goldman–Sosin–Gatto price of a floating-strike lookback.
+ *
+ * @param option 'c' (call, on the minimum) or 'p' (put, on the maximum).
+ * @param S Spot.
+ * @param extremum Observed minimum (call, <= S) or maximum (put, >= S).
+ * @param sigma Volatility (> 0).
+ * @param interest_rate Risk-free rate (>= 0).
+ * @param ttm Time to maturity in years (>= 0).
+ * @return Discounted price.
+ */
+double gsg_floating_strike_price(char option, double S, double extremum, double sigma, double interest_rate, double ttm);
+
+/**
+ * @brief Price and Greeks from the closed form, with the conventions of `look_back`.
+ *
+ * @details
+ * Vega and rho are per 1% move (scaled by 0.01), theta is \f$-\partial P/\partial T\f$
+ * per year. If `extremum_tracks_spot` is true (newly issued contract: the extremum is the
+ * spot itself, as in look_back::delta()), the price is homogeneous of degree one in S, so
+ * delta = price/S and gamma = 0 exactly. Otherwise the spot Greeks and, in all cases,
+ * vega, rho and theta are central differences of the closed form with steps small
+ * enough (relative 1e-4 .. 1e-5) to be accurate to about 1e-8.
+ */
+risk_line gsg_floating_strike_risk(char option, double S, double extremum, double sigma, double interest_rate,
+                                   double ttm, bool extremum_tracks_spot);
+
+#endif /* Analytic_Lookback_h */
@@ -0,0 +1,94 @@
+/**
+ * @file Concurrency_Governor.cpp
+ * @brief FIFO core budget implementation.
+ */
+
+#include "Concurrency_Governor.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include <omp.h>
+
+core_governor& core_governor::instance()
+{
+    static core_governor governor;
+    return governor;
+}
+
+core_governor::core_governor()
+    : budget_(default_budget())
+{
+}
+
+int core_governor::default_budget()
+{
+    if (const char* env = std::getenv("LB_THREAD_BUDGET"))
+    {
+        const int cores = std::atoi(env);
+        if (cores > 0)
+            return cores;
+    }
+    return std::max(1, omp_get_max_threads());
+}
+
+int core_governor::budget() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+void core_governor::set_budget(int cores)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = cores > 0 ? cores : default_budget();
+    }
+    turn_.notify_all();
+}
+
+int core_governor::acquire(int wanted)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::uint64_t ticket = next_ticket_++;
+    turn_.wait(lock, [&] { return ticket == serving_ && in_use_ < budget_; });
+
+    // fair share among the calls holding a lease and those queued behind us (us included)
+    const int waiting = static_cast<int>(next_ticket_ - serving_);
+    const int share = std::max(1, budget_ / (running_ + waiting));
+    const int granted = std::max(1, std::min({wanted, share, budget_ - in_use_}));
+
+    in_use_ += granted;
+    ++running_;
+    ++serving_;
+    lock.unlock();
+    turn_.notify_all();
+    return granted;
+}
+
+void core_governor::release(int cores)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_ -= cores;
+        --running_;
+    }
+    turn_.notify_all();
+}
+
+core_lease::core_lease(long wanted)
+{
+    // nested inside another team (even a one-thread one): the outer call holds the cores
+    if (omp_get_level() > 0)
+        return;
+
+    threads_ = core_governor::instance().acquire(static_cast<int>(std::clamp(wanted, 1L, static_cast<long>(INT_MAX))));
+    held_ = true;
+}
+
+core_lease::~core_lease()
+{
+    if (held_)
+        core_governor::instance().release(threads_);
+}
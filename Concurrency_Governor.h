@@ -0,0 +1,90 @@
+/**
+ * @file Concurrency_Governor.h
+ * @brief Library-wide core budget shared by concurrent pricing calls.
+ *
+ * @details
+ * Every simulation runs its chunks through numa_parallel_for(), which used to open a
+ * full-width OpenMP team per call. With many callers (Excel multithreaded recalculation,
+ * server threads) that oversubscribes the machine many times over.
+ *
+ * The governor owns a global budget of cores. numa_parallel_for() runs its tasks in
+ * rounds; before each round it takes a core_lease, sized to a fair share of the budget
+ * (budget / calls running or waiting), and opens a team of exactly that many threads.
+ * Leases are granted in FIFO order, and a caller waits only while the whole budget is
+ * in use. Since rounds are short, a call that started alone shrinks to its fair share
+ * as soon as other calls arrive, so the total number of busy threads stays at the
+ * budget and aggregate throughput at hardware peak. Results do not depend on the
+ * number of threads granted.
+ *
+ * The budget defaults to omp_get_max_threads() at first use; the environment variable
+ * `LB_THREAD_BUDGET` or set_budget() override it. Calls made from inside an OpenMP
+ * parallel region do not take a lease and run single-threaded.
+ */
+
+#ifndef Concurrency_Governor_h
+#define Concurrency_Governor_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+/** @ingroup LB_Core */
+class core_governor
+{
+public:
+    /** @brief Process-wide governor. */
+    static core_governor& instance();
+
+    /** @brief Total cores shared by all calls. */
+    int budget() const;
+
+    /**
+     * @brief Changes the budget (0 restores the default). Leases already granted are kept.
+     */
+    void set_budget(int cores);
+
+    /**
+     * @brief Blocks until this caller's turn, then grants between 1 and `wanted` cores.
+     * @return Number of cores granted.
+     */
+    int acquire(int wanted);
+
+    /** @brief Returns cores granted by acquire(). */
+    void release(int cores);
+
+private:
+    core_governor();
+
+    static int default_budget();
+
+    mutable std::mutex mutex_;
+    std::condition_variable turn_;
+    int budget_;
+    int in_use_ = 0;
+    int running_ = 0;              ///< Leases currently held
+    std::uint64_t next_ticket_ = 0;
+    std::uint64_t serving_ = 0;
+};
+
+/**
+ * @class core_lease
+ * @brief RAII lease of cores from core_governor::instance().
+ */
+class core_lease
+{
+public:
+    explicit core_lease(long wanted);
+    ~core_lease();
+
+    core_lease(const core_lease&) = delete;
+    core_lease& operator=(const core_lease&) = delete;
+
+    /** @brief Threads this lease allows. */
+    int threads() const { return threads_; }
+
+private:
+    int threads_ = 1;
+    bool held_ = false;
+};
+
+#endif /* Concurrency_Governor_h */
@@ -0,0 +1,127 @@
+/**
+ * @file Handle_Arena.cpp
+ * @brief Implementation of the generation-checked handle table.
+ */
+
+#include "Handle_Arena.h"
+
+#include <stdexcept>
+
+handle_arena& handle_arena::instance()
+{
+    static handle_arena arena;
+    return arena;
+}
+
+handle_arena::~handle_arena()
+{
+    for (auto& s : slabs_)
+        delete[] s.load(std::memory_order_relaxed);
+}
+
+std::uintptr_t handle_arena::create(const look_back& contract)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::uint32_t index;
+    if (free_head_ != kNoSlot)
+    {
+        index = free_head_;
+        free_head_ = slabs_[index / kSlabSize].load(std::memory_order_relaxed)[index % kSlabSize].next_free;
+    }
+    else
+    {
+        if (used_slots_ == kMaxSlabs * kSlabSize)
+            throw std::length_error("Handle table full.");
+
+        index = used_slots_++;
+        if (index % kSlabSize == 0)
+            slabs_[index / kSlabSize].store(new slot[kSlabSize], std::memory_order_release);
+    }
+
+    slot& s = slabs_[index / kSlabSize].load(std::memory_order_relaxed)[index % kSlabSize];
+    s.contract.emplace(contract);
+    const std::uintptr_t gen = s.generation.load(std::memory_order_relaxed) + 1;
+    s.generation.store(gen, std::memory_order_release);
+    ++live_;
+
+    return (gen << kIndexBits) | index;
+}
+
+handle_arena::slot* handle_arena::find(std::uintptr_t h) const
+{
+    const std::uintptr_t index = h & kIndexMask;
+    const std::uintptr_t gen = h >> kIndexBits;
+    if ((gen & 1) == 0)
+        return nullptr;
+
+    slot* slab = slabs_[index / kSlabSize].load(std::memory_order_acquire);
+    if (!slab)
+        return nullptr;
+
+    slot& s = slab[index % kSlabSize];
+    // generations are compared on the bits that fit in the handle
+    const std::uintptr_t live_gen = s.generation.load(std::memory_order_acquire);
+    if (((live_gen << kIndexBits) >> kIndexBits) != gen)
+        return nullptr;
+    return &s;
+}
+
+handle_arena::pinned handle_arena::get(std::uintptr_t h)
+{
+    slot* s = find(h);
+    if (!s)
+        return {};
+
+    // pin, then re-check: destroy() bumps the generation before it looks at the pins,
+    // so either it sees this pin or this sees the new generation
+    const std::uint32_t index = static_cast<std::uint32_t>(h & kIndexMask);
+    s->pins.fetch_add(1, std::memory_order_seq_cst);
+    const std::uintptr_t live_gen = s->generation.load(std::memory_order_seq_cst);
+    if (((live_gen << kIndexBits) >> kIndexBits) != (h >> kIndexBits))
+    {
+        unpin(s, index);
+        return {};
+    }
+    return pinned(this, s, index);
+}
+
+void handle_arena::unpin(slot* s, std::uint32_t index)
+{
+    if (s->pins.fetch_sub(1, std::memory_order_seq_cst) != 1)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (s->retired && s->pins.load(std::memory_order_seq_cst) == 0)
+        reclaim(s, index);
+}
+
+void handle_arena::reclaim(slot* s, std::uint32_t index)
+{
+    s->contract.reset();
+    s->retired = false;
+    s->next_free = free_head_;
+    free_head_ = index;
+}
+
+bool handle_arena::destroy(std::uintptr_t h)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    slot* s = find(h);
+    if (!s)
+        return false;
+
+    s->retired = true;
+    s->generation.store(s->generation.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+    if (s->pins.load(std::memory_order_seq_cst) == 0)
+        reclaim(s, static_cast<std::uint32_t>(h & kIndexMask));
+    --live_;
+    return true;
+}
+
+std::size_t handle_arena::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file Handle_Arena.h
+ * @brief Slab-backed table of `look_back` contracts addressed by generation-checked handles.
+ *
+ * @details
+ * Contracts created through the C ABI live in fixed-size slabs instead of individual
+ * heap allocations. A handle encodes the slot index and the slot generation at creation
+ * time; destroying a contract bumps the generation, so any later use of the old handle
+ * is detected with a single comparison.
+ *
+ * Handle layout (on a 64-bit platform): bits 0..23 slot index, bits 24..63 generation.
+ * Live slots always carry an odd generation, so a valid handle is never null.
+ *
+ * Each slot holds the full `look_back` (176 bytes on x86-64) rather than a smaller record
+ * rebuilt per call: handles carry mutable per-contract state (engine, estimator, Heston
+ * parameters, attached surface and sample store, observed extremum, tick cache) that
+ * must persist between calls.
+ *
+ * Thread-safety:
+ * - create() / destroy() serialize on an internal mutex.
+ * - get() is lock-free and pins the slot: a destroy() racing with a call in progress
+ *   invalidates the handle at once, but the contract is only released (and the slot
+ *   reused) when the last pin is dropped.
+ */
+
+#ifndef Handle_Arena_h
+#define Handle_Arena_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "Look_Back.h"
+
+/** @ingroup LB_Core */
+class handle_arena
+{
+public:
+    /// Bits of a handle holding the slot index.
+    static constexpr unsigned kIndexBits = 24;
+    /// Slots per slab (allocated together).
+    static constexpr std::size_t kSlabSize = 4096;
+    /// Maximum number of slabs, so that every slot index fits in kIndexBits.
+    static constexpr std::size_t kMaxSlabs = (std::size_t(1) << kIndexBits) / kSlabSize;
+
+    /** @brief Process-wide arena used by the C ABI. */
+    static handle_arena& instance();
+
+    handle_arena() = default;
+    handle_arena(const handle_arena&) = delete;
+    handle_arena& operator=(const handle_arena&) = delete;
+    ~handle_arena();
+
+    /**
+     * @brief Stores a contract in a free slot.
+     * @return Non-zero handle.
+     * @throws std::length_error when all slots are in use.
+     */
+    std::uintptr_t create(const look_back& contract);
+
+    class pinned;
+
+    /** @brief Pins the contract behind `h`; the result is empty if `h` is invalid or stale. */
+    pinned get(std::uintptr_t h);
+
+    /**
+     * @brief Invalidates `h` and releases its contract once no call holds it pinned.
+     * @return false if `h` is invalid or stale.
+     */
+    bool destroy(std::uintptr_t h);
+
+    /** @brief Number of live contracts. */
+    std::size_t size() const;
+
+private:
+    struct slot
+    {
+        std::optional<look_back> contract;
+        std::atomic<std::uintptr_t> generation{0}; // odd while live
+        std::atomic<std::uint32_t> pins{0};        // calls currently using the contract
+        bool retired = false;                      // destroyed, waiting for the last pin
+        std::uint32_t next_free = 0;
+    };
+
+    static constexpr std::uint32_t kNoSlot = 0xffffffffu;
+    static constexpr std::uintptr_t kIndexMask = (std::uintptr_t(1) << kIndexBits) - 1;
+
+    slot* find(std::uintptr_t h) const;
+    void unpin(slot* s, std::uint32_t index);
+    void reclaim(slot* s, std::uint32_t index); // requires mutex_
+
+    std::atomic<slot*> slabs_[kMaxSlabs] = {};
+    mutable std::mutex mutex_;
+    std::uint32_t free_head_ = kNoSlot;
+    std::uint32_t used_slots_ = 0; // slots handed out at least once
+    std::size_t live_ = 0;
+};
+
+/** @brief Keeps a contract alive while a call uses it (move-only; empty if the handle was invalid). */
+class handle_arena::pinned
+{
+public:
+    pinned() = default;
+    pinned(pinned&& o) noexcept : arena_(o.arena_), slot_(o.slot_), index_(o.index_) { o.slot_ = nullptr; }
+    pinned& operator=(pinned&& o) noexcept
+    {
+        if (this != &o)
+        {
+            release();
+            arena_ = o.arena_; slot_ = o.slot_; index_ = o.index_;
+            o.slot_ = nullptr;
+        }
+        return *this;
+    }
+    pinned(const pinned&) = delete;
+    pinned& operator=(const pinned&) = delete;
+    ~pinned() { release(); }
+
+    explicit operator bool() const { return slot_ != nullptr; }
+    look_back* get() const { return slot_ ? &*slot_->contract : nullptr; }
+    look_back* operator->() const { return get(); }
+    look_back& operator*() const { return *get(); }
+
+private:
+    friend class handle_arena;
+    pinned(handle_arena* arena, slot* s, std::uint32_t index) : arena_(arena), slot_(s), index_(index) {}
+
+    void release()
+    {
+        if (slot_)
+            arena_->unpin(slot_, index_);
+        slot_ = nullptr;
+    }
+
+    handle_arena* arena_ = nullptr;
+    slot* slot_ = nullptr;
+    std::uint32_t index_ = 0;
+};
+
+#endif /* Handle_Arena_h */
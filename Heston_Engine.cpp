@@ -0,0 +1,234 @@
+/**
+ * @file Heston_Engine.cpp
+ * @brief QE variance stepping with Brownian-bridge extremum, in SoA tiles.
+ */
+
+#include "Heston_Engine.h"
+#include "Look_Back_Kernel.h"
+#include "Vector_Math.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace
+{
+    /// Per-step constants of one pricing.
+    struct heston_step_params
+    {
+        double theta, ek, c1, c2; ///< QE moments: mean = theta + (v - theta) ek, variance = v c1 + c2
+        double drift, K1, K2, K3; ///< central discretization of the log-price
+        double dt;
+        double side;              ///< -0.5 for the running minimum (call), +0.5 for the maximum (put)
+        double sign;              ///< +1 (call) or -1 (put)
+    };
+
+    /// State and per-step draws of one tile, as separate arrays so each loop reads them contiguously.
+    struct heston_tile
+    {
+        double v[kHestonTilePaths], x_plus[kHestonTilePaths], x_minus[kHestonTilePaths];
+        double ext_plus[kHestonTilePaths], ext_minus[kHestonTilePaths];
+        std::uint64_t Zv[kHestonTilePaths], Uv[kHestonTilePaths], Zs[kHestonTilePaths]; ///< raw generator output
+        std::uint64_t U1[kHestonTilePaths], U2[kHestonTilePaths];                         ///< raw generator output
+        double pair[kHestonTilePaths];
+    };
+
+    /// (k + 1/2) 2^-52 from the top 52 bits k of a generator word: in (0, 1), and 1 - U is exact.
+    LB_ALWAYS_INLINE double open_uniform(std::uint64_t bits)
+    {
+        // 1 + k 2^-52 minus (1 - 2^-53); the subtraction is exact
+        return std::bit_cast<double>((bits >> 12) | 0x3ff0000000000000ull) - (1.0 - 0x1p-53);
+    }
+
+    /// One time step of the first `m` paths; inlined into each ISA variant like the GBM kernel.
+    LB_ALWAYS_INLINE void heston_step_body(const heston_step_params& c, heston_tile& t, unsigned int m)
+    {
+        for (unsigned int i = 0; i < m; ++i)
+        {
+            const double v = t.v[i];
+            const double zv = vm::normal_quantile(open_uniform(t.Zv[i]));
+            const double zs = vm::normal_quantile(open_uniform(t.Zs[i]));
+            const double mean = c.theta + (v - c.theta) * c.ek;
+            const double var = v * c.c1 + c.c2;
+            const double psi = var / (mean * mean);
+
+            // both QE branches are evaluated and one is kept, so the loop has no branch; caps are
+            // derived from the capped value, as in Vector_Math.h, since constant ones let GCC
+            // split the loop into paths it cannot if-convert below AVX-512
+
+            // quadratic branch, with psi capped at 1.5 (where it is used) so its root stays real
+            const double inv = 2.0 / std::min(psi, 0.0 * psi + 1.5);
+            const double b2 = inv - 1.0 + vm::sqrt(inv * (inv - 1.0));
+            const double b = vm::sqrt(b2);
+            const double quad = mean / (1.0 + b2) * (b + zv) * (b + zv);
+
+            // exponential branch: 0 when Uv <= q, where the log argument is at most 1
+            const double q = (psi - 1.0) / (psi + 1.0);
+            const double beta = (1.0 - q) / mean;
+            const double ratio = (1.0 - q) / (1.0 - open_uniform(t.Uv[i]));
+            const double expo = vm::log(std::max(ratio, 0.0 * ratio + 1.0)) / beta;
+
+            const double v_next = vm::select_sign(1.5 - psi, quad, expo); // quad where psi <= 1.5
+
+            const double base = c.drift + c.K1 * v + c.K2 * v_next;
+            const double diffusion = vm::sqrt(c.K3 * (v + v_next)) * zs;
+            const double var2 = (v + v_next) * c.dt; // 2 w
+
+            const double xp = t.x_plus[i] + base + diffusion;
+            const double xm = t.x_minus[i] + base - diffusion;
+            const double dp = xp - t.x_plus[i];
+            const double dm = xm - t.x_minus[i];
+
+            // both terms under each root are non-negative, as in the GBM kernel
+            const double bridge_plus  = 0.5 * (t.x_plus[i]  + xp) + c.side * vm::sqrt(dp*dp - var2 * vm::log(1.0 - open_uniform(t.U1[i])));
+            const double bridge_minus = 0.5 * (t.x_minus[i] + xm) + c.side * vm::sqrt(dm*dm - var2 * vm::log(1.0 - open_uniform(t.U2[i])));
+
+            // min for the call, max for the put
+            t.ext_plus[i]  = c.sign * std::min(c.sign * t.ext_plus[i],  c.sign * bridge_plus);
+            t.ext_minus[i] = c.sign * std::min(c.sign * t.ext_minus[i], c.sign * bridge_minus);
+            t.x_plus[i] = xp;
+            t.x_minus[i] = xm;
+            t.v[i] = v_next;
+        }
+    }
+
+    /// Pair payoffs of the first `m` paths, per unit of spot.
+    LB_ALWAYS_INLINE void heston_payoff_body(const heston_step_params& c, heston_tile& t, unsigned int m)
+    {
+        for (unsigned int i = 0; i < m; ++i)
+            t.pair[i] = c.sign * ((vm::exp(t.x_plus[i])  - vm::exp(t.ext_plus[i]))
+                                + (vm::exp(t.x_minus[i]) - vm::exp(t.ext_minus[i])));
+    }
+
+    typedef void (*heston_tile_fn)(const heston_step_params& c, heston_tile& t, unsigned int m);
+
+    void heston_step_baseline(const heston_step_params& c, heston_tile& t, unsigned int m) { heston_step_body(c, t, m); }
+    void heston_payoff_baseline(const heston_step_params& c, heston_tile& t, unsigned int m) { heston_payoff_body(c, t, m); }
+
+#ifdef LB_KERNEL_X86_DISPATCH
+    __attribute__((target("avx2,fma")))
+    void heston_step_avx2(const heston_step_params& c, heston_tile& t, unsigned int m) { heston_step_body(c, t, m); }
+
+    __attribute__((target("avx2,fma")))
+    void heston_payoff_avx2(const heston_step_params& c, heston_tile& t, unsigned int m) { heston_payoff_body(c, t, m); }
+
+    __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+    void heston_step_avx512(const heston_step_params& c, heston_tile& t, unsigned int m) { heston_step_body(c, t, m); }
+
+    __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+    void heston_payoff_avx512(const heston_step_params& c, heston_tile& t, unsigned int m) { heston_payoff_body(c, t, m); }
+#endif
+
+    /// Step and payoff variants for active_kernel_isa().
+    struct heston_tile_kernels
+    {
+        heston_tile_fn step;
+        heston_tile_fn payoff;
+    };
+
+    const heston_tile_kernels& active_heston_kernels()
+    {
+        static const heston_tile_kernels kernels = [] () -> heston_tile_kernels {
+            switch (active_kernel_isa())
+            {
+#ifdef LB_KERNEL_X86_DISPATCH
+                case kernel_isa::avx512: return {&heston_step_avx512, &heston_payoff_avx512};
+                case kernel_isa::avx2:   return {&heston_step_avx2,   &heston_payoff_avx2};
+#endif
+                default:                 return {&heston_step_baseline, &heston_payoff_baseline};
+            }
+        }();
+        return kernels;
+    }
+
+    /// Step constants for a step of length `dt`.
+    heston_step_params step_params(char option, const heston_params& h, double interest_rate, double dt)
+    {
+        heston_step_params c;
+        c.theta = h.theta;
+        c.dt = dt;
+
+        // QE constants (Andersen 2008)
+        c.ek = std::exp(-h.kappa * dt);
+        c.c1 = h.xi * h.xi * c.ek * (1.0 - c.ek) / h.kappa;
+        c.c2 = h.theta * h.xi * h.xi * (1.0 - c.ek) * (1.0 - c.ek) / (2.0 * h.kappa);
+
+        // central discretization of the log-price
+        const double K0 = -h.rho * h.kappa * h.theta * dt / h.xi;
+        c.K1 = 0.5 * dt * (h.kappa * h.rho / h.xi - 0.5) - h.rho / h.xi;
+        c.K2 = 0.5 * dt * (h.kappa * h.rho / h.xi - 0.5) + h.rho / h.xi;
+        c.K3 = 0.5 * dt * (1.0 - h.rho * h.rho);
+        c.drift = interest_rate * dt + K0;
+
+        // the running minimum (call) is below the bridge midpoint, the running maximum (put) above
+        c.side = (option == 'c') ? -0.5 : 0.5;
+        c.sign = (option == 'c') ? 1.0 : -1.0;
+        return c;
+    }
+}
+
+heston_chunk_sums heston_simulate_chunk(char option, const heston_params& h, const mc_point& p,
+                                        std::uint64_t chunk, unsigned int n, double observed)
+{
+    // fixed grid of 1 / steps_per_year, then a shorter step to the maturity, so a maturity
+    // bump changes only the last step and never which words the earlier steps draw
+    const double dt = 1.0 / h.steps_per_year;
+    const double grid = p.ttm * h.steps_per_year;
+    const unsigned int full = static_cast<unsigned int>(std::floor(grid + 1e-9));
+    const double last = (grid - full) * dt;
+    const bool partial = grid - full > 1e-9;
+    const unsigned int steps = full + partial;
+
+    const heston_step_params c = step_params(option, h, p.interest_rate, dt);
+    const heston_step_params c_last = partial ? step_params(option, h, p.interest_rate, last) : c;
+    const unsigned int T = kHestonTilePaths;
+
+    // running extremum at the valuation date, in log(S_t / S): the spot, or the observed one beyond it
+    const double ext0 = observed > 0 ? (c.side < 0 ? std::min(0.0, std::log(observed / p.S))
+                                                   : std::max(0.0, std::log(observed / p.S)))
+                                     : 0.0;
+
+    const heston_tile_kernels& kernels = active_heston_kernels();
+    const std::uint64_t chunk_seed = mc_substream_seed(chunk);
+    heston_tile t;
+
+    heston_chunk_sums sums;
+    for (unsigned int first = 0; first < n; first += T)
+    {
+        const unsigned int m = std::min(T, n - first);
+        // one substream per tile: its draws do not depend on the step count of earlier tiles
+        std::mt19937_64 gen(mc_substream_seed(chunk_seed + first / T));
+        for (unsigned int i = 0; i < m; ++i)
+        {
+            t.v[i] = p.sigma * p.sigma;
+            t.x_plus[i] = t.x_minus[i] = 0.0; // log(S_t / S)
+            t.ext_plus[i] = t.ext_minus[i] = ext0;
+        }
+
+        for (unsigned int s = 0; s < steps; ++s)
+        {
+            // five generator words per path and step, whatever the QE branch; the step turns
+            // them into uniforms and normals inside its vector loop
+            for (unsigned int i = 0; i < m; ++i)
+            {
+                t.Zv[i] = gen();
+                t.Uv[i] = gen();
+                t.Zs[i] = gen();
+                t.U1[i] = gen();
+                t.U2[i] = gen();
+            }
+            kernels.step(s + 1 < steps ? c : c_last, t, m);
+        }
+
+        kernels.payoff(c, t, m);
+        for (unsigned int i = 0; i < m; ++i)
+        {
+            const double pair = p.S * t.pair[i];
+            sums.sum += pair;
+            sums.sum_sq += pair * pair;
+        }
+    }
+    return sums;
+}
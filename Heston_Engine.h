@@ -0,0 +1,69 @@
+/**
+ * @file Heston_Engine.h
+ * @brief Monte Carlo paths of floating-strike lookbacks under Heston stochastic volatility.
+ *
+ * @details
+ * Dynamics under the pricing measure:
+ * \f[
+ *   dS_t = r S_t\,dt + \sqrt{v_t} S_t\,dW^S_t,\qquad
+ *   dv_t = \kappa(\theta - v_t)\,dt + \xi\sqrt{v_t}\,dW^v_t,\qquad
+ *   d\langle W^S, W^v\rangle_t = \rho\,dt.
+ * \f]
+ *
+ * Time steps have length 1 / steps_per_year; the last one is shortened to end at the
+ * maturity. Each step:
+ * - the variance follows Andersen's quadratic-exponential (QE) scheme (Andersen 2008,
+ *   switching at \f$\psi_c = 1.5\f$), which stays non-negative without truncation;
+ * - the log-price uses Andersen's central discretization (\f$\gamma_1 = \gamma_2 = 1/2\f$),
+ *   so the correlation enters through the variance increment;
+ * - the running extremum gets a Brownian-bridge correction: given both log-price ends
+ *   and the step's integrated variance \f$w = \tfrac12(v + v')\Delta\f$, the extremum
+ *   inside the step is sampled exactly, as in the GBM engine. Daily steps thus price the
+ *   continuously monitored contract.
+ *
+ * Paths are advanced in tiles of kHestonTilePaths antithetic pairs stored as
+ * structure-of-arrays. Each step first draws five raw 64-bit generator words per path
+ * (the generator is sequential, so this part is scalar), then one branch-free loop turns
+ * them into uniforms and normals (inverse normal CDF, vm::normal_quantile), advances the
+ * variance, log-prices and extrema, and evaluates both QE branches to keep one per path.
+ * That loop and the payoff loop take their math from Vector_Math.h and are built for the
+ * same instruction sets as the GBM kernel, with the variant chosen by active_kernel_isa()
+ * (see Look_Back_Kernel.h). The pair shares the variance path and uses \f$\pm Z\f$ for
+ * the independent part of the price shock.
+ *
+ * Each tile draws from its own substream, seeded from the chunk's (mc_substream_seed()), so
+ * results are deterministic and independent of the thread count. The words a tile draws at
+ * step k do not depend on how many steps follow: two maturities on either side of a step
+ * boundary (theta, the maturity axis of look_back::sample_curve) keep common random numbers
+ * on every path and differ only in their last, fractional step.
+ */
+
+#ifndef Heston_Engine_h
+#define Heston_Engine_h
+
+#include <cstdint>
+
+#include "Look_Back.h"
+
+/// Antithetic pairs advanced together (one SoA tile).
+inline constexpr unsigned int kHestonTilePaths = 256;
+
+/** @brief Payoff sums of one chunk (same convention as the GBM engine: pair sums). */
+struct heston_chunk_sums
+{
+    double sum = 0.0;
+    double sum_sq = 0.0;
+};
+
+/**
+ * @brief Simulates `n` antithetic pairs of substream `chunk`.
+ * @param option 'c' or 'p'.
+ * @param h Model parameters; the initial variance is `sigma^2` of the revaluation point `p`.
+ * @param p Revaluation point (spot, initial volatility, rate, maturity).
+ * @param observed Extremum observed before the valuation date (0 for a new contract).
+ * @return Undiscounted sums of pair payoffs.
+ */
+heston_chunk_sums heston_simulate_chunk(char option, const heston_params& h, const mc_point& p,
+                                        std::uint64_t chunk, unsigned int n, double observed);
+
+#endif /* Heston_Engine_h */
@@ -0,0 +1,180 @@
+/**
+ * @file Joint_Extrema.cpp
+ * @brief Image-series sampling of the bridge minimum given the maximum, and the joint pricer.
+ */
+
+#include "Joint_Extrema.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Numa_Topology.h"
+
+namespace
+{
+    /// Image terms are dropped once their exponent is below this (e^-45 ~ 3e-20).
+    constexpr double kNegligibleExponent = -45.0;
+    constexpr int kMaxImages = 1000;
+
+    /**
+     * P(m > a | W_t = b, M = c), a <= min(0, b) <= max(0, b) <= c. Every exponent is taken
+     * relative to the k = 0 term, which is the density of the maximum, so nothing overflows.
+     */
+    double min_survival(double a, double b, double c, double t)
+    {
+        const double w = c - a;
+        const double e0 = 2.0*c*(c - b)/t;
+        const double density = 2.0*c - b;
+
+        double s = density;
+        for (int k = 1; k <= kMaxImages; ++k)
+        {
+            double largest = -std::numeric_limits<double>::infinity();
+            for (const int j : {k, -k})
+            {
+                const double kw = j * w;
+                const double e1 = e0 - 2.0*kw*(kw - b)/t;
+                s -= j*(2.0*kw - b)*std::exp(e1);
+                largest = std::max(largest, e1);
+                if (j == 1)
+                    continue; // the second image family has weight 1 - j
+                const double u = c - kw;
+                const double e2 = e0 - 2.0*u*(u - b)/t;
+                s += (1 - j)*(2.0*u - b)*std::exp(e2);
+                largest = std::max(largest, e2);
+            }
+            if (largest < kNegligibleExponent)
+                break;
+        }
+        return std::min(1.0, std::max(0.0, s / density));
+    }
+
+    struct joint_sums
+    {
+        double sum[4] = {};
+        double sum_sq[4] = {};
+    };
+}
+
+double bridge_min_given_max(double b, double t, double c, double u)
+{
+    const double top = std::min(0.0, b);
+    // the maximum of a path whose endpoints are both ~0 carries no information to invert
+    if (!(2.0*c - b > 0))
+        return top;
+
+    // bracket [lo, top] with survival(lo) >= u > survival(top) = 0
+    const double scale = std::sqrt(t);
+    double lo = top - scale, f_lo = min_survival(lo, b, c, t) - u;
+    for (int i = 0; i < 60 && f_lo < 0; ++i)
+    {
+        lo = top - (top - lo) * 2.0;
+        f_lo = min_survival(lo, b, c, t) - u;
+    }
+    double hi = top, f_hi = -u;
+
+    // Illinois: regula falsi that halves the stale end's value, bisection if it stalls
+    int side = 0;
+    for (int i = 0; i < 100 && hi - lo > 1e-13 * (scale + std::fabs(top)); ++i)
+    {
+        double x = (lo * f_hi - hi * f_lo) / (f_hi - f_lo);
+        if (!(x > lo && x < hi))
+            x = 0.5 * (lo + hi);
+        const double f = min_survival(x, b, c, t) - u;
+        if (f == 0.0)
+            return x;
+        if (f > 0)
+        {
+            lo = x; f_lo = f;
+            if (side == 1) f_hi *= 0.5;
+            side = 1;
+        }
+        else
+        {
+            hi = x; f_hi = f;
+            if (side == -1) f_lo *= 0.5;
+            side = -1;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+joint_lookback_prices price_joint_lookbacks(double S, double sigma, double interest_rate, double ttm,
+                                            std::uint64_t N, double range_strike,
+                                            double observed_min, double observed_max)
+{
+    if (S <= 0 || sigma <= 0)
+        throw Invalid_Parameters("S and sigma must be positive.");
+    if (ttm < 0)
+        throw Invalid_Parameters("maturity date < value date in yearFraction.");
+    if (N == 0)
+        throw Invalid_Parameters("N must be positive.");
+    if (!(range_strike >= 0))
+        throw Invalid_Parameters("The range strike must be non-negative.");
+    if (observed_min < 0 || observed_max < 0 || (observed_min > 0 && observed_max > 0 && observed_min > observed_max))
+        throw Invalid_Parameters("Observed extrema must be positive with minimum <= maximum.");
+
+    const double mu = (interest_rate - 0.5*sigma*sigma)*ttm;
+    const double vol = sigma*std::sqrt(ttm);
+    const double t = sigma*sigma*ttm;
+    const double floor_min = observed_min > 0 ? observed_min : std::numeric_limits<double>::infinity();
+    const double cap_max = observed_max;
+
+    const std::uint64_t n_chunks = chunk_count(N);
+    std::vector<joint_sums> partial(n_chunks);
+
+    numa_parallel_for(static_cast<long>(n_chunks), [&](long c)
+    {
+        const std::uint64_t chunk = static_cast<std::uint64_t>(c);
+        const unsigned int n = std::min<std::uint64_t>(kMcChunkPaths, N - chunk * kMcChunkPaths);
+
+        // per pair the normal, then the maximum and minimum uniforms of each path
+        mc_substream substream(chunk);
+
+        joint_sums& out = partial[chunk];
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            const double Z = substream.normal();
+            double pair[4] = {};
+            for (int a = 0; a < 2; ++a)
+            {
+                const double x = mu + (a == 0 ? -vol : vol) * Z; // same sign convention as look_back::price()
+                double lo = std::min(0.0, x), hi = std::max(0.0, x);
+                if (t > 0)
+                {
+                    hi = 0.5*(x + std::sqrt(x*x - 2.0*t*std::log(1.0 - substream.uniform())));
+                    lo = bridge_min_given_max(x, t, hi, substream.uniform());
+                }
+
+                const double ST = S * std::exp(x);
+                const double m = std::min(floor_min, S * std::exp(lo));
+                const double M = std::max(cap_max, S * std::exp(hi));
+                pair[0] += ST - m;
+                pair[1] += M - ST;
+                pair[2] += M - m;
+                pair[3] += std::max(M - m - range_strike, 0.0);
+            }
+            for (int q = 0; q < 4; ++q)
+            {
+                out.sum[q] += pair[q];
+                out.sum_sq[q] += pair[q] * pair[q];
+            }
+        }
+    });
+
+    mc_estimate estimates[4];
+    for (int q = 0; q < 4; ++q)
+    {
+        compensated_sum sum, sum_sq;
+        for (const joint_sums& p : partial)
+        {
+            sum.add(p.sum[q]);
+            sum_sq.add(p.sum_sq[q]);
+        }
+
+        estimates[q] = make_estimate(std::exp(-interest_rate * ttm), sum, sum_sq, N, N);
+    }
+    return {estimates[0], estimates[1], estimates[2], estimates[3]};
+}
@@ -0,0 +1,62 @@
+/**
+ * @file Joint_Extrema.h
+ * @brief Joint simulation of (X_T, m_T, M_T) for lookback straddles and range options.
+ *
+ * @details
+ * Calls and puts only need the law of one extremum given the endpoint, which is why
+ * look_back samples them independently. Range payoffs need the joint law of the minimum
+ * and the maximum. Given the log-price endpoint b (a Brownian bridge from 0 to b with
+ * variance t = sigma^2 T, the drift drops out by conditioning), each path draws:
+ * - the maximum exactly, \f$c = \tfrac12\big(b + \sqrt{b^2 - 2t\log U}\big)\f$;
+ * - the minimum from its law given the endpoint and the maximum. With
+ *   \f$G(a, c) = P(a < W < c \mid W_t = b)\f$ from the method of images,
+ *   \f[ P(m > a \mid W_t = b,\, M = c) = \partial_c G(a, c) \,/\, \partial_c G(-\infty, c), \f]
+ *   a series in the image index k whose terms decay like \f$e^{-2k^2 (c-a)^2/t}\f$. It is
+ *   truncated once every further term is below \f$e^{-45}\f$ and inverted by bracketed
+ *   regula falsi (Illinois), with bisection as a fallback.
+ *
+ * One path set then prices, with common random numbers:
+ * - the floating-strike call \f$S_T - m_T\f$ and put \f$M_T - S_T\f$;
+ * - the straddle (call + put), whose payoff is exactly the range \f$M_T - m_T\f$;
+ * - the range option \f$\max(M_T - m_T - K, 0)\f$, which depends on the joint law.
+ *
+ * An extremum observed before the valuation date (seasoned trades) caps the simulated one.
+ * Pairs are antithetic in the Gaussian endpoint; each path uses its own two uniforms.
+ * Dynamics are GBM (constant sigma and rate).
+ */
+
+#ifndef Joint_Extrema_h
+#define Joint_Extrema_h
+
+#include <cstdint>
+
+#include "Look_Back.h"
+
+/** @brief Estimates of the products priced from one joint path set. */
+struct joint_lookback_prices
+{
+    mc_estimate call;
+    mc_estimate put;
+    mc_estimate straddle; ///< Call + put: payoff M_T - m_T
+    mc_estimate range;    ///< Range option max(M_T - m_T - K, 0)
+};
+
+/**
+ * @brief Minimum of a Brownian bridge from 0 to `b` (variance `t`) given its maximum `c`.
+ * @param u Uniform in (0, 1): the result is the `u`-quantile of P(m > a | b, c) inverted.
+ * @details Requires t > 0 and c >= max(0, b). Exposed for validation.
+ */
+double bridge_min_given_max(double b, double t, double c, double u);
+
+/**
+ * @brief Prices call, put, straddle and range option from `N` antithetic pairs of joint paths.
+ * @param range_strike Strike K of the range option (in price units, K >= 0).
+ * @param observed_min Minimum observed before the valuation date (0 = newly issued).
+ * @param observed_max Maximum observed before the valuation date (0 = newly issued).
+ * @throws Invalid_Parameters on invalid market data, K < 0, inconsistent observed extrema or N = 0.
+ */
+joint_lookback_prices price_joint_lookbacks(double S, double sigma, double interest_rate, double ttm,
+                                            std::uint64_t N, double range_strike = 0.0,
+                                            double observed_min = 0.0, double observed_max = 0.0);
+
+#endif /* Joint_Extrema_h */
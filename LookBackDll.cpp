@@ -25,8 +25,21 @@
 #include <algorithm>
 #include <exception>
 #include <cstring>   // memcpy
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include "Look_Back.h"
+#include "Handle_Arena.h"
+#include "Joint_Extrema.h"
+#include "Concurrency_Governor.h"
+#include "Look_Back_Kernel.h"
+#include "Multi_Maturity.h"
+#include "Numa_Topology.h"
+#include "Price_Surface.h"
+#include "Result_File.h"
+#include "Sample_Store.h"
 #include "Date_Dealing.h"
 #include "Invalid_Parameters.h"
 
@@ -66,9 +79,23 @@ static DayCountConv map_ddc(int ddc)
     }
 }
 
-static look_back* as_ptr(LB_Handle h)
+/**
+ * @brief Resolves and pins a handle through the arena; empty if it is null, invalid or stale.
+ * @details The pin keeps the contract alive until the call returns, even if another thread
+ *          destroys the handle meanwhile.
+ */
+static handle_arena::pinned as_ptr(LB_Handle h)
+{
+    return handle_arena::instance().get(reinterpret_cast<std::uintptr_t>(h));
+}
+
+/** @brief Graph point count for step `dx`, rejecting counts that do not fit the ABI's int. */
+static int graph_size(const look_back& lb, double dx)
 {
-    return reinterpret_cast<look_back*>(h);
+    const std::size_t n = lb.graphic_size(dx);
+    if (n > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        throw Invalid_Parameters("dx is too small: the graph would exceed INT_MAX points.");
+    return static_cast<int>(n);
 }
 
 LB_API LB_Handle LB_CALL LB_CreateA(
@@ -100,8 +127,8 @@ LB_API LB_Handle LB_CALL LB_CreateA(
         const char opt = static_cast<char>(option_ascii);
         const DayCountConv ddc = map_ddc(day_count_conv);
 
-        look_back* obj = new look_back(S0, vd, md, sigma, interest_rate, opt, h, ddc);
-        return reinterpret_cast<LB_Handle>(obj);
+        const std::uintptr_t handle = handle_arena::instance().create(look_back(S0, vd, md, sigma, interest_rate, opt, h, ddc));
+        return reinterpret_cast<LB_Handle>(handle);
     }
     catch (const std::exception& e)
     {
@@ -120,7 +147,8 @@ LB_API void LB_CALL LB_Destroy(LB_Handle h)
     clear_error();
     try
     {
-        delete as_ptr(h);
+        if (h && !handle_arena::instance().destroy(reinterpret_cast<std::uintptr_t>(h)))
+            set_error_a("Invalid or stale handle in LB_Destroy");
     }
     catch (...)
     {
@@ -128,25 +156,362 @@ LB_API void LB_CALL LB_Destroy(LB_Handle h)
     }
 }
 
+LB_API int LB_CALL LB_SetThreadBudget(int cores)
+{
+    clear_error();
+    if (cores < 0) { set_error_a("Negative core budget in LB_SetThreadBudget"); return 0; }
+    core_governor::instance().set_budget(cores);
+    return 1;
+}
+
+LB_API int LB_CALL LB_GetThreadBudget(void)
+{
+    clear_error();
+    return core_governor::instance().budget();
+}
+
+LB_API int LB_CALL LB_SetEngine(LB_Handle h, int engine)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_SetEngine"); return 0; }
+        if (engine < LB_ENGINE_AUTO || engine > LB_ENGINE_SURFACE) { set_error_a("Unknown engine in LB_SetEngine"); return 0; }
+
+        lb->set_engine(static_cast<pricing_engine>(engine));
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_SetEngine", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_SetEngine"); return 0; }
+}
+
+LB_API int LB_CALL LB_SetHeston(LB_Handle h, double kappa, double theta, double xi, double rho, unsigned int steps_per_year)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_SetHeston"); return 0; }
+
+        lb->set_heston({kappa, theta, xi, rho, steps_per_year});
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_SetHeston", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_SetHeston"); return 0; }
+}
+
+LB_API int LB_CALL LB_SetBlackScholes(LB_Handle h)
+{
+    clear_error();
+    const handle_arena::pinned lb = as_ptr(h);
+    if (!lb) { set_error_a("Invalid or stale handle in LB_SetBlackScholes"); return 0; }
+
+    lb->set_black_scholes();
+    return 1;
+}
+
+LB_API int LB_CALL LB_SetEstimator(LB_Handle h, int estimator)
+{
+    clear_error();
+    const handle_arena::pinned lb = as_ptr(h);
+    if (!lb) { set_error_a("Invalid or stale handle in LB_SetEstimator"); return 0; }
+    if (estimator < LB_ESTIMATOR_ANTITHETIC || estimator > LB_ESTIMATOR_MOMENT_MATCHED) { set_error_a("Unknown estimator in LB_SetEstimator"); return 0; }
+
+    lb->set_estimator(static_cast<mc_estimator>(estimator));
+    return 1;
+}
+
+LB_API double LB_CALL LB_EstimateF32Bias(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                         unsigned long long N, double* se_out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_EstimateF32Bias"); return 0.0; }
+
+        const mc_estimate e = lb->estimate_f32_bias(S, sigma, interest_rate, maturity, N);
+        if (se_out) *se_out = e.se;
+        return e.price;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_EstimateF32Bias", e); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_EstimateF32Bias"); return 0.0; }
+}
+
+/**
+ * @brief Surfaces already mapped, by path. An entry is reused while the path still names the
+ * file it mapped; after a rebuild the new file is mapped, and the old mapping lives on only
+ * in the handles still attached to it.
+ */
+static std::shared_ptr<const price_surface> shared_surface(const std::string& path)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const price_surface>> surfaces;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::weak_ptr<const price_surface>& cached = surfaces[path];
+    std::shared_ptr<const price_surface> s = cached.lock();
+    if (!s || !s->is_current(path))
+    {
+        s = std::make_shared<const price_surface>(path);
+        cached = s;
+    }
+    return s;
+}
+
+LB_API int LB_CALL LB_AttachSurface(LB_Handle h, const char* path)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_AttachSurface"); return 0; }
+
+        if (!path)
+        {
+            lb->set_surface(nullptr);
+            return 1;
+        }
+        lb->set_surface(shared_surface(path));
+        lb->set_engine(pricing_engine::surface);
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_AttachSurface", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_AttachSurface"); return 0; }
+}
+
+LB_API int LB_CALL LB_UseSampleStore(LB_Handle h, unsigned long long pairs)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_UseSampleStore"); return 0; }
+
+        lb->set_sample_store(pairs == 0 ? nullptr : sample_store::shared(pairs));
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_UseSampleStore", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_UseSampleStore"); return 0; }
+}
+
+LB_API int LB_CALL LB_SetObservedExtremum(LB_Handle h, double extremum)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_SetObservedExtremum"); return 0; }
+
+        if (extremum == 0.0)
+            lb->clear_observed_extremum();
+        else
+            lb->set_observed_extremum(extremum);
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_SetObservedExtremum", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_SetObservedExtremum"); return 0; }
+}
+
+LB_API int LB_CALL LB_PrepareTicks(LB_Handle h, unsigned long long N)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_PrepareTicks"); return 0; }
+
+        lb->prepare_ticks(N);
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PrepareTicks", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_PrepareTicks"); return 0; }
+}
+
+LB_API double LB_CALL LB_PriceTick(LB_Handle h, double S, double* delta_out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_PriceTick"); return 0.0; }
+
+        const tick_quote q = lb->tick(S);
+        if (delta_out) *delta_out = q.delta;
+        return q.price;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceTick", e); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceTick"); return 0.0; }
+}
+
+LB_API int LB_CALL LB_GetActiveEngine(LB_Handle h)
+{
+    clear_error();
+    const handle_arena::pinned lb = as_ptr(h);
+    if (!lb) { set_error_a("Invalid or stale handle in LB_GetActiveEngine"); return -1; }
+    return static_cast<int>(lb->active_engine());
+}
+
 LB_API double LB_CALL LB_Price(LB_Handle h, double S, double sigma, double interest_rate, double maturity, unsigned int N)
 {
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_Price"); return 0.0; }
-        return as_ptr(h)->price(S, sigma, interest_rate, maturity, N);
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_Price"); return 0.0; }
+        return lb->price(S, sigma, interest_rate, maturity, N);
     }
     catch (const std::exception& e) { set_error_from_exception("LB_Price", e); return 0.0; }
     catch (...) { set_error_a("Unknown error in LB_Price"); return 0.0; }
 }
 
+/** @brief Forwards core progress reports to an ABI callback (calling convention adapter). */
+struct progress_sink
+{
+    LB_ProgressCallback cb;
+    void* user;
+
+    static bool forward(void* context, const mc_estimate& running)
+    {
+        const progress_sink* sink = static_cast<const progress_sink*>(context);
+        return sink->cb(sink->user, running.price, running.se, running.paths) == LB_PROGRESS_CONTINUE;
+    }
+};
+
+LB_API double LB_CALL LB_PriceProgressive(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                          unsigned long long N, unsigned long long every, LB_ProgressCallback cb, void* user,
+                                          double* se_out, unsigned long long* paths_out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_PriceProgressive"); return 0.0; }
+
+        progress_sink sink{cb, user};
+        const mc_estimate e = lb->estimate_progressive(S, sigma, interest_rate, maturity, N, every,
+                                                       cb ? &progress_sink::forward : nullptr, &sink);
+        if (se_out) *se_out = e.se;
+        if (paths_out) *paths_out = e.paths;
+        return e.price;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceProgressive", e); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceProgressive"); return 0.0; }
+}
+
+LB_API double LB_CALL LB_PriceLarge(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                    unsigned long long N, double* se_out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_PriceLarge"); return 0.0; }
+
+        const mc_estimate e = lb->estimate(S, sigma, interest_rate, maturity, N);
+        if (se_out) *se_out = e.se;
+        return e.price;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceLarge", e); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceLarge"); return 0.0; }
+}
+
+LB_API double LB_CALL LB_PriceCheckpointed(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                           unsigned long long N, const char* path, unsigned long long every, double* se_out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_PriceCheckpointed"); return 0.0; }
+        if (!path) { set_error_a("Null checkpoint path in LB_PriceCheckpointed"); return 0.0; }
+
+        const mc_estimate e = lb->estimate_checkpointed(S, sigma, interest_rate, maturity, N, path, every);
+        if (se_out) *se_out = e.se;
+        return e.price;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceCheckpointed", e); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceCheckpointed"); return 0.0; }
+}
+
+LB_API double LB_CALL LB_PriceWithin(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                     double budget_ms, double* se_out, unsigned long long* paths_out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_PriceWithin"); return 0.0; }
+
+        const mc_estimate e = lb->estimate_within(S, sigma, interest_rate, maturity, budget_ms / 1000.0);
+        if (se_out) *se_out = e.se;
+        if (paths_out) *paths_out = e.paths;
+        return e.price;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceWithin", e); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceWithin"); return 0.0; }
+}
+
+LB_API int LB_CALL LB_PriceSharedPaths(const LB_Handle* handles, int n, unsigned long long N, double* prices_out, double* se_out)
+{
+    clear_error();
+    try
+    {
+        if (!handles || !prices_out || n <= 0) { set_error_a("Null or empty input in LB_PriceSharedPaths"); return 0; }
+
+        std::vector<handle_arena::pinned> pins;
+        std::vector<const look_back*> contracts;
+        for (int i = 0; i < n; ++i)
+        {
+            pins.push_back(as_ptr(handles[i]));
+            if (!pins.back()) { set_error_a("Invalid or stale handle in LB_PriceSharedPaths at index " + std::to_string(i)); return 0; }
+            contracts.push_back(pins.back().get());
+        }
+
+        const std::vector<mc_estimate> e = price_maturity_strip(contracts, N);
+        for (int i = 0; i < n; ++i)
+        {
+            prices_out[i] = e[static_cast<size_t>(i)].price;
+            if (se_out) se_out[i] = e[static_cast<size_t>(i)].se;
+        }
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceSharedPaths", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceSharedPaths"); return 0; }
+}
+
+LB_API int LB_CALL LB_PriceJoint(double S, double sigma, double interest_rate, double maturity, unsigned long long N,
+                                 double range_strike, double observed_min, double observed_max,
+                                 double* prices_out, double* se_out)
+{
+    clear_error();
+    try
+    {
+        if (!prices_out) { set_error_a("Null output in LB_PriceJoint"); return 0; }
+
+        const joint_lookback_prices j = price_joint_lookbacks(S, sigma, interest_rate, maturity, N, range_strike,
+                                                              observed_min, observed_max);
+        const mc_estimate* e[LB_JOINT_COUNT] = {&j.call, &j.put, &j.straddle, &j.range};
+        for (int q = 0; q < LB_JOINT_COUNT; ++q)
+        {
+            prices_out[q] = e[q]->price;
+            if (se_out) se_out[q] = e[q]->se;
+        }
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_PriceJoint", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_PriceJoint"); return 0; }
+}
+
 LB_API double LB_CALL LB_Delta(LB_Handle h, double S)
 {
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_Delta"); return 0.0; }
-        return as_ptr(h)->delta(S);
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_Delta"); return 0.0; }
+        return lb->delta(S);
     }
     catch (const std::exception& e) { set_error_from_exception("LB_Delta", e); return 0.0; }
     catch (...) { set_error_a("Unknown error in LB_Delta"); return 0.0; }
@@ -157,8 +522,9 @@ LB_API double LB_CALL LB_Theta(LB_Handle h)
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_Theta"); return 0.0; }
-        return as_ptr(h)->theta();
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_Theta"); return 0.0; }
+        return lb->theta();
     }
     catch (const std::exception& e) { set_error_from_exception("LB_Theta", e); return 0.0; }
     catch (...) { set_error_a("Unknown error in LB_Theta"); return 0.0; }
@@ -169,8 +535,9 @@ LB_API double LB_CALL LB_Rho(LB_Handle h)
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_Rho"); return 0.0; }
-        return as_ptr(h)->rho();
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_Rho"); return 0.0; }
+        return lb->rho();
     }
     catch (const std::exception& e) { set_error_from_exception("LB_Rho", e); return 0.0; }
     catch (...) { set_error_a("Unknown error in LB_Rho"); return 0.0; }
@@ -181,8 +548,9 @@ LB_API double LB_CALL LB_Vega(LB_Handle h)
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_Vega"); return 0.0; }
-        return as_ptr(h)->vega();
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_Vega"); return 0.0; }
+        return lb->vega();
     }
     catch (const std::exception& e) { set_error_from_exception("LB_Vega", e); return 0.0; }
     catch (...) { set_error_a("Unknown error in LB_Vega"); return 0.0; }
@@ -193,33 +561,118 @@ LB_API double LB_CALL LB_Gamma(LB_Handle h)
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_Gamma"); return 0.0; }
-        return as_ptr(h)->gamma();
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_Gamma"); return 0.0; }
+        return lb->gamma();
     }
     catch (const std::exception& e) { set_error_from_exception("LB_Gamma", e); return 0.0; }
     catch (...) { set_error_a("Unknown error in LB_Gamma"); return 0.0; }
 }
 
-LB_API int LB_CALL LB_GraphicPrice(LB_Handle h, double dx, double* x_out, double* y_out, int max_len)
+LB_API int LB_CALL LB_RiskReport(LB_Handle h, unsigned long long N, LB_Risk* out)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_RiskReport"); return 0; }
+        if (!out) { set_error_a("Null output in LB_RiskReport"); return 0; }
+
+        const risk_line r = lb->risk_report(N);
+        out->price = r.price;
+        out->delta = r.delta;
+        out->gamma = r.gamma;
+        out->vega  = r.vega;
+        out->rho   = r.rho;
+        out->theta = r.theta;
+        return 1;
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_RiskReport", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_RiskReport"); return 0; }
+}
+
+LB_API int LB_CALL LB_WriteRiskReports(const LB_Handle* handles, const unsigned long long* keys, int n, unsigned long long N, const char* path)
 {
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_GraphicPrice"); return 0; }
+        if (!handles || !path || n <= 0) { set_error_a("Null or empty input in LB_WriteRiskReports"); return 0; }
 
-        auto graph = as_ptr(h)->graphic_price(dx);
-        const int n = static_cast<int>(graph[0].size());
+        // the header describes every row: the batch must share one engine and one estimator
+        std::vector<handle_arena::pinned> contracts(static_cast<std::size_t>(n));
+        const look_back* first = nullptr;
+        for (int i = 0; i < n; ++i)
+        {
+            contracts[i] = as_ptr(handles[i]);
+            if (!contracts[i])
+                continue;
+            if (!first)
+                first = contracts[i].get();
+            else if (contracts[i]->active_engine() != first->active_engine() || contracts[i]->estimator() != first->estimator())
+            {
+                set_error_a("Mixed engines or estimators in LB_WriteRiskReports at index " + std::to_string(i));
+                return 0;
+            }
+        }
 
-        if (!x_out || !y_out || max_len <= 0)
-            return n;
+        result_metadata meta;
+        if (first)
+        {
+            meta.estimator = first->estimator();
+            // closed-form rows simulate no paths
+            meta.paths = first->active_engine() == pricing_engine::analytic ? 0 : N;
+        }
+        result_writer writer(path, static_cast<std::uint64_t>(n), meta);
 
-        const int k = std::min(n, max_len);
-        for (int i = 0; i < k; ++i)
+        // one contract at a time: risk_report() already spreads its revaluations over the
+        // whole core budget
+        for (int i = 0; i < n; ++i)
         {
-            x_out[i] = graph[0][static_cast<size_t>(i)];
-            y_out[i] = graph[1][static_cast<size_t>(i)];
+            const handle_arena::pinned& lb = contracts[i];
+            if (!lb)
+            {
+                if (g_lastErrorA.empty())
+                    set_error_a("Invalid or stale handle in LB_WriteRiskReports at index " + std::to_string(i));
+                continue;
+            }
+
+            const risk_line r = lb->risk_report(N);
+            writer.append({keys ? keys[i] : static_cast<std::uint64_t>(i), r.price, r.price_se,
+                           r.delta, r.gamma, r.vega, r.rho, r.theta});
         }
-        return k;
+
+        writer.close();
+        return static_cast<int>(writer.size());
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_WriteRiskReports", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_WriteRiskReports"); return 0; }
+}
+
+/** @brief Forwards core graph points to an ABI callback (calling convention adapter). */
+struct point_sink
+{
+    LB_PointCallback cb;
+    void* user;
+
+    static void forward(void* context, std::size_t index, double x, double y)
+    {
+        const point_sink* sink = static_cast<const point_sink*>(context);
+        sink->cb(sink->user, static_cast<int>(index), x, y);
+    }
+};
+
+LB_API int LB_CALL LB_GraphicPrice(LB_Handle h, double dx, double* x_out, double* y_out, int max_len)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_GraphicPrice"); return 0; }
+
+        if (!x_out || !y_out || max_len <= 0)
+            return graph_size(*lb, dx);
+
+        return static_cast<int>(lb->graphic_price(dx, x_out, y_out, static_cast<size_t>(max_len)));
     }
     catch (const std::exception& e) { set_error_from_exception("LB_GraphicPrice", e); return 0; }
     catch (...) { set_error_a("Unknown error in LB_GraphicPrice"); return 0; }
@@ -230,26 +683,177 @@ LB_API int LB_CALL LB_GraphicDelta(LB_Handle h, double dx, double* x_out, double
     clear_error();
     try
     {
-        if (!h) { set_error_a("Null handle in LB_GraphicDelta"); return 0; }
-
-        auto graph = as_ptr(h)->graphic_delta(dx);
-        const int n = static_cast<int>(graph[0].size());
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_GraphicDelta"); return 0; }
 
         if (!x_out || !y_out || max_len <= 0)
-            return n;
+            return graph_size(*lb, dx);
 
-        const int k = std::min(n, max_len);
-        for (int i = 0; i < k; ++i)
-        {
-            x_out[i] = graph[0][static_cast<size_t>(i)];
-            y_out[i] = graph[1][static_cast<size_t>(i)];
-        }
-        return k;
+        return static_cast<int>(lb->graphic_delta(dx, x_out, y_out, static_cast<size_t>(max_len)));
     }
     catch (const std::exception& e) { set_error_from_exception("LB_GraphicDelta", e); return 0; }
     catch (...) { set_error_a("Unknown error in LB_GraphicDelta"); return 0; }
 }
 
+LB_API int LB_CALL LB_GraphicPriceStream(LB_Handle h, double dx, double* x_out, double* y_out, int max_len, LB_PointCallback cb, void* user)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_GraphicPriceStream"); return 0; }
+        if (!x_out || !y_out || max_len <= 0) { set_error_a("Null or empty buffers in LB_GraphicPriceStream"); return 0; }
+
+        point_sink sink{cb, user};
+        return static_cast<int>(lb->graphic_price(dx, x_out, y_out, static_cast<size_t>(max_len),
+                                                         cb ? &point_sink::forward : nullptr, &sink));
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_GraphicPriceStream", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_GraphicPriceStream"); return 0; }
+}
+
+LB_API int LB_CALL LB_GraphicDeltaStream(LB_Handle h, double dx, double* x_out, double* y_out, int max_len, LB_PointCallback cb, void* user)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_GraphicDeltaStream"); return 0; }
+        if (!x_out || !y_out || max_len <= 0) { set_error_a("Null or empty buffers in LB_GraphicDeltaStream"); return 0; }
+
+        point_sink sink{cb, user};
+        return static_cast<int>(lb->graphic_delta(dx, x_out, y_out, static_cast<size_t>(max_len),
+                                                         cb ? &point_sink::forward : nullptr, &sink));
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_GraphicDeltaStream", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_GraphicDeltaStream"); return 0; }
+}
+
+LB_API int LB_CALL LB_SampleCurve(LB_Handle h, int axis, int quantity, double lo, double hi,
+                                  int initial_points, int max_points, double budget_ms, unsigned long long N,
+                                  double tolerance, double* x_out, double* y_out, double* se_out, int max_len)
+{
+    clear_error();
+    try
+    {
+        const handle_arena::pinned lb = as_ptr(h);
+        if (!lb) { set_error_a("Invalid or stale handle in LB_SampleCurve"); return 0; }
+        if (axis < LB_CURVE_SPOT || axis > LB_CURVE_MATURITY) { set_error_a("Unknown curve axis in LB_SampleCurve"); return 0; }
+        if (quantity < LB_CURVE_PRICE || quantity > LB_CURVE_VEGA) { set_error_a("Unknown curve quantity in LB_SampleCurve"); return 0; }
+        if (initial_points < 3 || max_points < initial_points) { set_error_a("Invalid point budget in LB_SampleCurve"); return 0; }
+
+        if (!x_out || !y_out || max_len <= 0)
+            return max_points;
+
+        curve_request request{static_cast<curve_axis>(axis), static_cast<curve_quantity>(quantity), lo, hi};
+        request.initial_points = static_cast<size_t>(initial_points);
+        request.max_points = static_cast<size_t>(std::min(max_points, max_len));
+        if (request.max_points < request.initial_points) { set_error_a("Buffers too small for the initial grid in LB_SampleCurve"); return 0; }
+        request.seconds = budget_ms / 1000.0;
+        request.N = N;
+        request.tolerance = tolerance;
+
+        const std::vector<curve_point> curve = lb->sample_curve(request);
+        for (size_t i = 0; i < curve.size(); ++i)
+        {
+            x_out[i] = curve[i].x;
+            y_out[i] = curve[i].y;
+            if (se_out)
+                se_out[i] = curve[i].se;
+        }
+        return static_cast<int>(curve.size());
+    }
+    catch (const std::exception& e) { set_error_from_exception("LB_SampleCurve", e); return 0; }
+    catch (...) { set_error_a("Unknown error in LB_SampleCurve"); return 0; }
+}
+
+LB_API int LB_CALL LB_CreateBulkA(
+    int n,
+    const double* S0,
+    const char* const* value_dates_dd_mm_yyyy,
+    const char* const* maturity_dates_dd_mm_yyyy,
+    const double* sigma,
+    const double* interest_rate,
+    const int* option_ascii,
+    const double* h,
+    const int* day_count_conv,
+    LB_Handle* out
+)
+{
+    clear_error();
+    if (n <= 0) return 0;
+    if (!S0 || !value_dates_dd_mm_yyyy || !maturity_dates_dd_mm_yyyy || !sigma || !interest_rate
+        || !option_ascii || !h || !day_count_conv || !out)
+    {
+        set_error_a("Null array in LB_CreateBulkA");
+        return 0;
+    }
+
+    int created = 0;
+    std::string first_error;
+    for (int i = 0; i < n; ++i)
+    {
+        out[i] = LB_CreateA(S0[i], value_dates_dd_mm_yyyy[i], maturity_dates_dd_mm_yyyy[i], sigma[i],
+                            interest_rate[i], option_ascii[i], h[i], day_count_conv[i]);
+        if (out[i])
+            ++created;
+        else if (first_error.empty())
+            first_error = "LB_CreateBulkA[" + std::to_string(i) + "]: " + g_lastErrorA;
+    }
+
+    g_lastErrorA = first_error;
+    return created;
+}
+
+LB_API int LB_CALL LB_DestroyBulk(const LB_Handle* handles, int n)
+{
+    clear_error();
+    if (!handles || n <= 0) return 0;
+
+    int destroyed = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (!handles[i])
+            continue;
+        if (handle_arena::instance().destroy(reinterpret_cast<std::uintptr_t>(handles[i])))
+            ++destroyed;
+        else if (g_lastErrorA.empty())
+            set_error_a("Invalid or stale handle in LB_DestroyBulk at index " + std::to_string(i));
+    }
+    return destroyed;
+}
+
+LB_API int LB_CALL LB_IsValidHandle(LB_Handle h)
+{
+    return as_ptr(h) ? 1 : 0;
+}
+
+LB_API int LB_CALL LB_GetNumaNodes()
+{
+    return static_cast<int>(numa_topology::instance().nodes());
+}
+
+LB_API int LB_CALL LB_GetKernelIsa()
+{
+    return static_cast<int>(active_kernel_isa());
+}
+
+LB_API int LB_CALL LB_GetKernelIsaNameA(char* buffer, int buffer_len)
+{
+    const std::string name = kernel_isa_name(active_kernel_isa());
+    const int needed = static_cast<int>(name.size()) + 1;
+
+    if (!buffer || buffer_len <= 0)
+        return needed;
+
+    const int to_copy = std::min(buffer_len - 1, static_cast<int>(name.size()));
+    if (to_copy > 0)
+        std::memcpy(buffer, name.data(), static_cast<size_t>(to_copy));
+
+    buffer[to_copy] = '\0';
+    return to_copy + 1;
+}
+
 LB_API double LB_CALL LB_GetYearFraction(const char* start_date, const char* end_date, int day_count_conv)
 {
     clear_error(); // Clear previous error
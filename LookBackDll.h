@@ -13,6 +13,15 @@
  *   LB_GetLastErrorA().
  * - **Platform calling conventions**: LB_CALL and LB_API handle Windows vs macOS/Linux.
  * - **Day count conventions**: the C enum maps to the C++ `DayCountConv`.
+ * - **Handles** index a slab-backed table (see Handle_Arena.h); using a destroyed handle
+ *   is detected and reported as an error instead of touching freed memory. A call in
+ *   progress keeps its contract alive if another thread destroys the handle meanwhile.
+ * - **Concurrency**: any number of threads may price through the same handle at once.
+ *   The calls that change a handle (LB_SetEngine, LB_SetEstimator, LB_SetHeston,
+ *   LB_SetBlackScholes, LB_AttachSurface, LB_UseSampleStore, LB_SetObservedExtremum and
+ *   LB_PrepareTicks) may run concurrently with them: they publish a new settings snapshot,
+ *   and a call in progress finishes with the snapshot it started with. Concurrent calls
+ *   share one core budget (LB_SetThreadBudget) instead of each opening a full-width thread team.
  *
  * Build note:
  * - Paste your exact dynamic library build command here once finalized (clang++ flags,
@@ -62,6 +71,7 @@ enum LB_DayCountConv : int {
  * @typedef LB_Handle
  * @brief Opaque handle to a C++ `look_back` instance.
  * @details The caller owns the handle and must release it with LB_Destroy().
+ * The value is a generation-checked slot reference, not a pointer.
  */
 typedef void* LB_Handle;
 
@@ -114,22 +124,267 @@ LB_API LB_Handle LB_CALL LB_CreateW(
 /**
  * @brief Destroys a pricer instance created by LB_CreateA / LB_CreateW.
  * @param h Handle returned by LB_CreateA / LB_CreateW. Safe to pass nullptr.
+ * @details A handle that was already destroyed sets the last error and is otherwise ignored.
+ * Calls already running on `h` in other threads finish normally; the instance is released
+ * when the last one returns.
  */
 LB_API void LB_CALL LB_Destroy(LB_Handle h);
 
 /**
- * @brief Prices the lookback option by Monte Carlo.
- * @details Returns 0.0 on error and sets the last error message.
+ * @brief Creates `n` pricer instances from parallel input arrays.
+ * @details
+ * Element `i` of every array describes contract `i` (same meaning as the LB_CreateA
+ * arguments). Failed entries get a null handle in `out[i]`; the last error describes
+ * the first failure.
+ * @return Number of handles successfully created.
+ */
+LB_API int LB_CALL LB_CreateBulkA(
+    int n,
+    const double* S0,
+    const char* const* value_dates_dd_mm_yyyy,
+    const char* const* maturity_dates_dd_mm_yyyy,
+    const double* sigma,
+    const double* interest_rate,
+    const int* option_ascii,
+    const double* h,
+    const int* day_count_conv,
+    LB_Handle* out
+);
+
+/**
+ * @brief Destroys `n` handles. Null entries are skipped.
+ * @return Number of handles destroyed; stale handles set the last error.
+ */
+LB_API int LB_CALL LB_DestroyBulk(const LB_Handle* handles, int n);
+
+/** @brief Returns 1 if `h` refers to a live instance, 0 if it is null, invalid or destroyed. */
+LB_API int LB_CALL LB_IsValidHandle(LB_Handle h);
+
+/**
+ * @brief Sets the number of cores shared by all concurrent pricing calls.
+ * @param cores Core budget; 0 restores the default (OpenMP max threads or `LB_THREAD_BUDGET`).
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_SetThreadBudget(int cores);
+
+/** @brief Current core budget shared by concurrent calls. */
+LB_API int LB_CALL LB_GetThreadBudget(void);
+
+/**
+ * @enum LB_Engine
+ * @brief Pricing engines selectable with LB_SetEngine().
+ */
+enum LB_Engine : int {
+    LB_ENGINE_AUTO        = 0, ///< Closed form when applicable, Monte Carlo otherwise (default).
+    LB_ENGINE_MONTE_CARLO = 1,
+    LB_ENGINE_ANALYTIC    = 2,
+    LB_ENGINE_SURFACE     = 3  ///< Interpolated price surface (LB_AttachSurface); simulation outside its grid.
+};
+
+/**
+ * @brief Selects the engine used by LB_Price, the Greeks, LB_RiskReport and the graphs.
+ * @return 1 on success, 0 on error (e.g. analytic requested for a contract it does not fit).
+ */
+LB_API int LB_CALL LB_SetEngine(LB_Handle h, int engine);
+
+/**
+ * @brief Switches `h` to Heston stochastic-volatility dynamics (sigma becomes the initial volatility).
+ * @details Price, Greeks, risk report and graphs then use the Heston Monte Carlo engine.
+ * @param kappa Mean-reversion speed (> 0).
+ * @param theta Long-run variance (> 0).
+ * @param xi Volatility of variance (> 0).
+ * @param rho Spot/variance correlation in [-1, 1].
+ * @param steps_per_year Time steps per year (e.g. 252).
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_SetHeston(LB_Handle h, double kappa, double theta, double xi, double rho, unsigned int steps_per_year);
+
+/** @brief Returns `h` to flat-volatility (GBM) dynamics. @return 1 on success, 0 on error. */
+LB_API int LB_CALL LB_SetBlackScholes(LB_Handle h);
+
+/**
+ * @enum LB_Estimator
+ * @brief Monte Carlo estimators selectable with LB_SetEstimator().
+ */
+enum LB_Estimator : int {
+    LB_ESTIMATOR_ANTITHETIC     = 0, ///< Double-precision kernel (default).
+    LB_ESTIMATOR_ANTITHETIC_F32 = 1, ///< Single-precision per-path math, double accumulation.
+    LB_ESTIMATOR_MOMENT_MATCHED = 2  ///< Moment-matched blocks with reflected extremum uniforms.
+};
+
+/**
+ * @brief Selects the estimator used by every Monte Carlo simulation of `h`.
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_SetEstimator(LB_Handle h, int estimator);
+
+/**
+ * @brief Bias of the single-precision kernel: mean (float - double) discounted payoff on common draws.
+ * @param se_out Optional: standard error of the returned bias.
+ * @return The bias, or 0.0 on error.
+ */
+LB_API double LB_CALL LB_EstimateF32Bias(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                         unsigned long long N, double* se_out);
+
+/**
+ * @brief Attaches the price surface stored at `path` to `h` and selects LB_ENGINE_SURFACE.
+ * @details The file is mapped once per path and shared by all handles attached to it.
+ * Rebuilding the file (tools/surface_builder replaces it atomically) does not affect handles
+ * already attached; attaching again maps the new file.
+ * Pass a null `path` to detach (the handle returns to LB_ENGINE_AUTO).
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_AttachSurface(LB_Handle h, const char* path);
+
+/**
+ * @brief Makes `h` read its draws from a shared store of `pairs` precomputed antithetic pairs.
+ * @details The store is generated on first use and shared by every handle asking for the same
+ * size (24 bytes per pair). Runs of at most `pairs` pairs then skip the random number
+ * generation, with identical results. Pass 0 to detach.
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_UseSampleStore(LB_Handle h, unsigned long long pairs);
+
+/**
+ * @brief Seasons `h`: `extremum` is the minimum (call) or maximum (put) observed since the trade date.
+ * @details Every engine then prices S_T - min(extremum, future minimum), respectively
+ * max(extremum, future maximum) - S_T. Pass 0 to return to a newly issued contract.
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_SetObservedExtremum(LB_Handle h, double extremum);
+
+/**
+ * @brief Simulates `N` pairs at the contract's sigma, rate and maturity and caches them for LB_PriceTick.
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_PrepareTicks(LB_Handle h, unsigned long long N);
+
+/**
+ * @brief Monte Carlo price at spot `S` from the LB_PrepareTicks cache, in O(log N).
+ * @param delta_out Optional; receives the pathwise delta.
+ * @return Price, or 0.0 on error.
+ */
+LB_API double LB_CALL LB_PriceTick(LB_Handle h, double S, double* delta_out);
+
+/** @brief Engine actually used by `h`: LB_ENGINE_MONTE_CARLO, LB_ENGINE_ANALYTIC or LB_ENGINE_SURFACE (-1 on error). */
+LB_API int LB_CALL LB_GetActiveEngine(LB_Handle h);
+
+/**
+ * @brief Prices the lookback option (Monte Carlo, or closed form if the active engine is analytic).
+ * @details Returns 0.0 on error and sets the last error message. `N` is ignored by the analytic engine.
  * @param h Valid handle.
  * @param S Spot at which to price.
  * @param sigma Volatility.
  * @param interest_rate Rate.
  * @param maturity Time-to-maturity (year fraction).
- * @param N Number of Monte Carlo samples.
+ * @param N Number of Monte Carlo samples (LB_PriceLarge() takes counts beyond 32 bits).
  * @return Option price (discounted), or 0.0 on error.
  */
 LB_API double LB_CALL LB_Price(LB_Handle h, double S, double sigma, double interest_rate, double maturity, unsigned int N);
 
+/// Value returned by an LB_ProgressCallback to keep simulating.
+#define LB_PROGRESS_CONTINUE 0
+/// Value returned by an LB_ProgressCallback to stop and keep the current estimate.
+#define LB_PROGRESS_STOP     1
+
+/**
+ * @typedef LB_ProgressCallback
+ * @brief Receives the running estimate: (user, estimate, standard error, paths completed).
+ * @return LB_PROGRESS_CONTINUE or LB_PROGRESS_STOP.
+ */
+typedef int (LB_CALL *LB_ProgressCallback)(void* user, double estimate, double se, unsigned long long paths_done);
+
+/**
+ * @brief Prices by Monte Carlo, reporting the running estimate to `cb` every `every` paths.
+ * @details
+ * If the callback returns LB_PROGRESS_STOP the simulation ends early and the estimate
+ * from the paths completed so far is returned. An uninterrupted run returns the same
+ * value as look_back::estimate() (or LB_PriceLarge()) with the same N; it differs from
+ * LB_Price() whenever the handle resolves to the analytic or surface engine.
+ * @param se_out Optional: standard error of the returned estimate.
+ * @param paths_out Optional: number of paths actually simulated.
+ * @return Option price (discounted), or 0.0 on error.
+ */
+LB_API double LB_CALL LB_PriceProgressive(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                          unsigned long long N, unsigned long long every, LB_ProgressCallback cb, void* user,
+                                          double* se_out, unsigned long long* paths_out);
+
+/**
+ * @brief Prices with a 64-bit path count, for reference runs beyond 2^32 antithetic pairs.
+ * @details Always Monte Carlo (ignores the analytic engine). Chunk sums are merged with
+ * compensated summation, so 10^10-path runs keep full double accuracy.
+ * @param N Number of antithetic pairs.
+ * @param se_out Optional: standard error of the returned estimate.
+ * @return Option price (discounted), or 0.0 on error.
+ */
+LB_API double LB_CALL LB_PriceLarge(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                    unsigned long long N, double* se_out);
+
+/**
+ * @brief Prices by Monte Carlo, saving a checkpoint to `path` every `every` paths.
+ * @details
+ * If `path` holds a checkpoint of the same run, pricing resumes from it; the result is
+ * exactly the value of look_back::estimate() (or LB_PriceLarge()) with the same N, not
+ * LB_Price() when the handle resolves to the analytic or surface engine.
+ * The file is removed on completion.
+ * A checkpoint from a different run (other inputs, seed or kernel) is an error.
+ * @param path Checkpoint file path (UTF-8 / narrow).
+ * @param every Paths between checkpoints (0 = one chunk).
+ * @param se_out Optional: standard error of the returned estimate.
+ * @return Option price (discounted), or 0.0 on error.
+ */
+LB_API double LB_CALL LB_PriceCheckpointed(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                           unsigned long long N, const char* path, unsigned long long every, double* se_out);
+
+/**
+ * @brief Prices with a wall-clock budget instead of a path count.
+ * @details
+ * Simulates until just before `budget_ms` milliseconds have elapsed (never less than one
+ * window of one chunk per thread) and returns the estimate reached, with its standard
+ * error and the number of antithetic pairs simulated.
+ * @param budget_ms Time budget in milliseconds, measured from the call.
+ * @param se_out Optional: standard error of the returned estimate.
+ * @param paths_out Optional: number of paths actually simulated.
+ * @return Option price (discounted), or 0.0 on error.
+ */
+LB_API double LB_CALL LB_PriceWithin(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                     double budget_ms, double* se_out, unsigned long long* paths_out);
+
+/**
+ * @brief Prices several contracts on the same underlying from one shared path set.
+ * @details
+ * The handles must share spot, volatility, rate and valuation date (maturities and option
+ * types may differ). Each path is simulated once through all maturities, so the cost
+ * scales with N and the number of distinct maturities, not with the number of contracts.
+ * @param prices_out Output prices (n entries).
+ * @param se_out Optional standard errors (n entries, may be null).
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_PriceSharedPaths(const LB_Handle* handles, int n, unsigned long long N, double* prices_out, double* se_out);
+
+/** @brief Products priced by LB_PriceJoint, in output order. */
+enum LB_JointProduct : int {
+    LB_JOINT_CALL     = 0, ///< S_T - m_T
+    LB_JOINT_PUT      = 1, ///< M_T - S_T
+    LB_JOINT_STRADDLE = 2, ///< Call + put, i.e. M_T - m_T
+    LB_JOINT_RANGE    = 3, ///< max(M_T - m_T - range_strike, 0)
+    LB_JOINT_COUNT    = 4
+};
+
+/**
+ * @brief Prices call, put, straddle and range option of one underlying from one set of joint
+ *        (S_T, min, max) paths.
+ * @details The minimum is sampled from its law given the endpoint and the maximum, so the
+ * range option sees the joint law of both extrema. Pass 0 for observed_min / observed_max
+ * on a newly issued trade.
+ * @param prices_out Output prices (LB_JOINT_COUNT entries, see LB_JointProduct).
+ * @param se_out Optional standard errors (LB_JOINT_COUNT entries, may be null).
+ * @return 1 on success, 0 on error.
+ */
+LB_API int LB_CALL LB_PriceJoint(double S, double sigma, double interest_rate, double maturity, unsigned long long N,
+                                 double range_strike, double observed_min, double observed_max,
+                                 double* prices_out, double* se_out);
+
 // ---- Greeks ----
 LB_API double LB_CALL LB_Delta(LB_Handle h, double S);
 
@@ -141,10 +396,130 @@ LB_API double LB_CALL LB_Vega(LB_Handle h);
 
 LB_API double LB_CALL LB_Gamma(LB_Handle h);
 
+/**
+ * @struct LB_Risk
+ * @brief Price and Greeks of one contract, filled by LB_RiskReport().
+ * @details Field layout matches a VBA `Type` of six `Double`s.
+ */
+typedef struct LB_Risk
+{
+    double price;
+    double delta;
+    double gamma;
+    double vega;
+    double rho;
+    double theta;
+} LB_Risk;
+
+/**
+ * @brief Computes price, delta, gamma, vega, rho and theta in one scheduling pass.
+ * @details
+ * The bumped revaluations of all Greeks are deduplicated and priced concurrently,
+ * instead of six sequential calls to LB_Price / LB_Delta / ... .
+ * @param h Valid handle.
+ * @param N Number of Monte Carlo samples used for the price.
+ * @param out Output structure (must not be null).
+ * @return 1 on success, 0 on error (last error is set).
+ */
+LB_API int LB_CALL LB_RiskReport(LB_Handle h, unsigned long long N, LB_Risk* out);
+
+/**
+ * @brief Computes risk reports for `n` handles and stores them in a result file.
+ * @details
+ * Writes the columnar binary format of Result_File.h (one row per handle: key, price,
+ * SE, Greeks, plus seed/N/estimator metadata), to be read zero-copy with `result_reader`.
+ * Invalid handles are skipped. The metadata holds for every row, so all valid handles must
+ * use the same engine (LB_GetActiveEngine) and estimator; the file records N as the paths
+ * of Monte Carlo rows and 0 when the rows are closed-form. Rows on a surface grid have SE 0.
+ * @param handles Contracts to report on.
+ * @param keys Contract keys stored with each row; null uses the array index.
+ * @param n Number of handles.
+ * @param N Number of Monte Carlo samples used for the prices.
+ * @param path Output file (created or truncated).
+ * @return Number of rows written, or 0 on error.
+ */
+LB_API int LB_CALL LB_WriteRiskReports(const LB_Handle* handles, const unsigned long long* keys, int n, unsigned long long N, const char* path);
+
 // ---- Graphs ----
+
+/**
+ * @brief Fills (S, price(S)) points for plotting.
+ * @details
+ * Size query: if `x_out` or `y_out` is null, or `max_len<=0`, returns the number of
+ * points for step `dx` without running any simulation. Otherwise prices at most
+ * `max_len` points directly into the caller buffers and returns the count written.
+ * @return Point count, or 0 on error.
+ */
 LB_API int LB_CALL LB_GraphicPrice(LB_Handle h, double dx, double* x_out, double* y_out, int max_len);
+
+/** @brief Fills (S, delta(S)) points for plotting (same protocol as LB_GraphicPrice()). */
 LB_API int LB_CALL LB_GraphicDelta(LB_Handle h, double dx, double* x_out, double* y_out, int max_len);
 
+/**
+ * @typedef LB_PointCallback
+ * @brief Receives each graph point as soon as it is written: (user, index, x, y).
+ */
+typedef void (LB_CALL *LB_PointCallback)(void* user, int index, double x, double y);
+
+/**
+ * @brief Streaming variant of LB_GraphicPrice(): `cb` (may be null) is invoked for each point.
+ * @details Buffers are mandatory; use LB_GraphicPrice() with null buffers for the size query.
+ * Points are priced in windows of 16 and delivered in order as each window completes, with
+ * the same values as LB_GraphicPrice().
+ */
+LB_API int LB_CALL LB_GraphicPriceStream(LB_Handle h, double dx, double* x_out, double* y_out, int max_len, LB_PointCallback cb, void* user);
+
+/** @brief Streaming variant of LB_GraphicDelta() (see LB_GraphicPriceStream()). */
+LB_API int LB_CALL LB_GraphicDeltaStream(LB_Handle h, double dx, double* x_out, double* y_out, int max_len, LB_PointCallback cb, void* user);
+
+/** @brief Variable swept by LB_SampleCurve(). */
+enum LB_CurveAxis : int {
+    LB_CURVE_SPOT       = 0,
+    LB_CURVE_VOLATILITY = 1,
+    LB_CURVE_MATURITY   = 2  ///< Time to maturity in years
+};
+
+/** @brief Quantity charted by LB_SampleCurve(). */
+enum LB_CurveQuantity : int {
+    LB_CURVE_PRICE = 0,
+    LB_CURVE_DELTA = 1,
+    LB_CURVE_GAMMA = 2,
+    LB_CURVE_VEGA  = 3   ///< Per volatility point, as LB_Vega()
+};
+
+/**
+ * @brief Samples a price or Greek profile on [lo, hi], refining where it bends.
+ * @details
+ * Starts from `initial_points` (>= 3) evenly spaced points priced together on shared draws,
+ * then adds midpoints where the interpolation error stands above both `tolerance` and the
+ * Monte Carlo noise, until `max_points` or `budget_ms` (0 = no time limit) is reached.
+ * With `tolerance` > 0, points noisier than it are re-priced with more paths.
+ * `N` = 0 uses the library defaults. See look_back::sample_curve().
+ *
+ * Size query: if `x_out` or `y_out` is null, or `max_len<=0`, returns `max_points`
+ * (the largest possible count) without pricing.
+ * @param se_out Optional standard errors (may be null).
+ * @return Number of points written (sorted by x), or 0 on error.
+ */
+LB_API int LB_CALL LB_SampleCurve(LB_Handle h, int axis, int quantity, double lo, double hi,
+                                  int initial_points, int max_points, double budget_ms, unsigned long long N,
+                                  double tolerance, double* x_out, double* y_out, double* se_out, int max_len);
+
+/** @brief Number of NUMA nodes the engine schedules work across (1 when placement is inactive). */
+LB_API int LB_CALL LB_GetNumaNodes();
+
+/**
+ * @brief Instruction-set variant of the pricing kernel selected at load time.
+ * @return 0 baseline (SSE2 on x86-64), 1 AVX2+FMA, 2 AVX-512.
+ */
+LB_API int LB_CALL LB_GetKernelIsa();
+
+/**
+ * @brief Name of the active kernel variant ("baseline", "avx2", "avx512").
+ * @details Same buffer protocol as LB_GetLastErrorA().
+ */
+LB_API int LB_CALL LB_GetKernelIsaNameA(char* buffer, int buffer_len);
+
 // Date function
 LB_API double LB_CALL LB_GetYearFraction(const char* start_date, const char* end_date, int day_count_conv);
 
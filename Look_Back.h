@@ -12,8 +12,12 @@
  *
  * The class offers:
  * - Monte Carlo pricing (option payoff estimated under GBM assumptions).
+ * - An analytic engine (Goldman–Sosin–Gatto closed form), selected automatically
+ *   when the contract fits its assumptions (see pricing_engine).
  * - Greeks computed via finite differences around the stored baseline parameters.
- * - Simple graph helpers for price/delta as a function of spot.
+ * - Graph helpers for price/delta as a function of spot, and an adaptive curve sampler
+ *   for price and Greeks against spot, volatility or maturity.
+ * - Seasoned contracts (extremum observed since the trade date) and fast tick revaluation.
  *
  * Error model:
  * - The core C++ implementation may throw exceptions (e.g., Invalid_Parameters).
@@ -43,8 +47,20 @@
 
 #ifndef LOOK_BACK_H
 #define LOOK_BACK_H
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "Date_Dealing.h"
 #include "Invalid_Parameters.h"
@@ -52,6 +68,264 @@
 /// Alias used for graph output (x,y vectors).
 typedef std::vector<double> vect;
 
+/// Seed of the Monte Carlo substream family (recorded in result files).
+inline constexpr std::uint64_t kMcSeed = 0x9e3779b97f4a7c15ULL;
+
+/** @brief Monte Carlo estimators (identifiers are stable: they are stored in result files). */
+enum class mc_estimator : std::uint32_t
+{
+    antithetic = 0,    ///< Antithetic pairs on the Gaussian, independent extremum uniforms.
+    antithetic_f32 = 1, ///< Same draws, per-path math in single precision, sums in double.
+    moment_matched = 2  ///< Blocks of 4096 pairs: half reflected (U -> 1 - U), normals rescaled; SE from block means. Bias O(1/block).
+};
+
+/**
+ * @brief Seed of Monte Carlo substream `chunk`.
+ * @details Shared by all simulation engines so that chunk `k` always draws the same numbers.
+ */
+std::uint64_t mc_substream_seed(std::uint64_t chunk);
+
+/// Paths simulated per RNG substream; also the unit of work handed to a thread.
+inline constexpr unsigned int kMcChunkPaths = 1u << 15;
+
+/// Number of chunks holding `pairs` pairs (written to avoid overflow near 2^64).
+inline std::uint64_t chunk_count(std::uint64_t pairs)
+{
+    return pairs / kMcChunkPaths + (pairs % kMcChunkPaths != 0);
+}
+
+/**
+ * @brief Draws of Monte Carlo substream `chunk`, as every GBM engine consumes them.
+ * @details Standard normals and uniforms clamped to [1e-15, 1 - 1e-15], so that log(U) and
+ * log(1 - U) stay finite. Engines that sample more than one step per pair take them one by
+ * one with normal() and uniform(); the others take whole pairs with draw().
+ */
+class mc_substream
+{
+public:
+    explicit mc_substream(std::uint64_t chunk) : gen_(mc_substream_seed(chunk)) {}
+
+    double normal() { return gaussian_(gen_); }
+
+    double uniform()
+    {
+        constexpr double eps = 1e-15;
+        return std::min(1.0 - eps, std::max(eps, uniform_(gen_)));
+    }
+
+    /** @brief Next `n` pairs: per pair the normal Z, then the extremum uniforms U1 and U2. */
+    void draw(unsigned int n, double* Z, double* U1, double* U2)
+    {
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            Z[i] = normal();
+            U1[i] = uniform();
+            U2[i] = uniform();
+        }
+    }
+
+private:
+    std::mt19937_64 gen_;
+    std::normal_distribution<double> gaussian_{0.0, 1.0};
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+};
+
+/** @brief The first `n` pairs of substream `chunk` (see mc_substream::draw()). */
+inline void draw_chunk(std::uint64_t chunk, unsigned int n, double* Z, double* U1, double* U2)
+{
+    mc_substream(chunk).draw(n, Z, U1, U2);
+}
+
+/**
+ * @brief Neumaier-compensated running sum.
+ * @details Merges chunk partials: a 10^10-path run adds ~3e5 chunk sums, enough for a
+ * plain double accumulator to lose digits the estimate still resolves.
+ */
+struct compensated_sum
+{
+    double sum = 0.0;
+    double c = 0.0; ///< Running compensation
+
+    void add(double x)
+    {
+        const double t = sum + x;
+        c += std::abs(sum) >= std::abs(x) ? (sum - t) + x : (x - t) + sum;
+        sum = t;
+    }
+
+    double value() const { return sum + c; }
+};
+
+/**
+ * @brief Pricing engines behind look_back::price(), the Greeks and risk_report().
+ * @details Identifiers are part of the C ABI (LB_SetEngine).
+ */
+enum class pricing_engine : std::uint32_t
+{
+    automatic = 0,   ///< Analytic when the contract fits its assumptions, Monte Carlo otherwise.
+    monte_carlo = 1, ///< Always simulate.
+    analytic = 2,    ///< Always use the closed form (fails if the contract does not fit).
+    surface = 3      ///< Interpolate an attached price_surface; simulate outside its grid.
+};
+
+class price_surface;
+class sample_store;
+class tick_revaluator;
+
+/**
+ * @struct mc_estimate
+ * @brief Monte Carlo price together with its standard error.
+ */
+struct mc_estimate
+{
+    double price;
+    double se;            ///< Standard error of `price`.
+    std::uint64_t paths;  ///< Number of antithetic pairs simulated.
+};
+
+/**
+ * @brief Discounted estimate of `pairs` antithetic pairs.
+ * @param sum Sum of the pair payoffs (both paths of each pair).
+ * @param sum_sq Sum over the `units` independent units (single pairs, or blocks) of
+ *        (unit sum)^2 / (pairs in unit).
+ */
+mc_estimate make_estimate(double discount, const compensated_sum& sum, const compensated_sum& sum_sq,
+                          std::uint64_t units, std::uint64_t pairs);
+
+/** @brief Price and pathwise delta of one tick revaluation (look_back::tick()). */
+struct tick_quote
+{
+    double price;
+    double delta;
+};
+
+/**
+ * @brief Callback receiving the running Monte Carlo estimate.
+ * @details Arguments are (context, estimate so far). Return false to stop the simulation.
+ */
+typedef bool (*progress_fn)(void* context, const mc_estimate& running);
+
+/**
+ * @brief Callback receiving graph points as soon as they are computed.
+ * @details Arguments are (context, point index, x, y).
+ */
+typedef void (*graph_point_fn)(void* context, std::size_t index, double x, double y);
+
+/**
+ * @struct mc_point
+ * @brief One Monte Carlo revaluation request: market point and number of paths.
+ */
+struct mc_point
+{
+    double S;
+    double sigma;
+    double interest_rate;
+    double ttm;
+    std::uint64_t N; ///< Antithetic pairs
+};
+
+/**
+ * @struct heston_params
+ * @brief Heston stochastic-volatility parameters (see Heston_Engine.h).
+ * @details The initial variance is sigma^2 of the contract (or of the revaluation point),
+ * so vega is the sensitivity to the initial volatility.
+ */
+struct heston_params
+{
+    double kappa;                       ///< Mean-reversion speed (> 0)
+    double theta;                       ///< Long-run variance (> 0)
+    double xi;                          ///< Volatility of variance (> 0)
+    double rho;                         ///< Spot/variance correlation, in [-1, 1]
+    unsigned int steps_per_year = 252;  ///< Time steps per year (> 0)
+};
+
+/** @brief Quantities reported by look_back::risk_report(). */
+enum class risk_measure { price, delta, gamma, vega, rho, theta };
+
+/**
+ * @struct risk_line
+ * @brief Price and Greeks of one contract, as filled by look_back::risk_report().
+ */
+struct risk_line
+{
+    double price;
+    double delta;
+    double gamma;
+    double vega;
+    double rho;
+    double theta;
+    double price_se; ///< Standard error of `price`.
+};
+
+/**
+ * @struct greek_stencil
+ * @brief Finite-difference stencil: a measure as a linear combination of revaluations.
+ *
+ * @details
+ * `index[k]` refers to a position in the `mc_point` list the stencil was built
+ * against, `weight[k]` is the coefficient applied to the corresponding price.
+ */
+struct greek_stencil
+{
+    std::size_t index[3];
+    double weight[3];
+    std::size_t size;
+
+    /** @brief Applies the stencil to the prices returned by look_back::price_batch(). */
+    double evaluate(const std::vector<double>& prices) const;
+};
+
+/** @brief Variable swept by look_back::sample_curve(). Identifiers are part of the C ABI. */
+enum class curve_axis : std::uint32_t
+{
+    spot = 0,
+    volatility = 1,
+    maturity = 2   ///< Time to maturity in years
+};
+
+/** @brief Quantity charted by look_back::sample_curve(). Identifiers are part of the C ABI. */
+enum class curve_quantity : std::uint32_t
+{
+    price = 0,
+    delta = 1,
+    gamma = 2,
+    vega = 3
+};
+
+/// Default antithetic pairs per curve revaluation (curve_request::N = 0, price points).
+inline constexpr std::uint64_t kCurvePairs = std::uint64_t(1) << 17;
+
+/// Fewest shared substreams for a batch-means standard error of a curve Greek.
+inline constexpr std::uint64_t kCurveMinBatches = 8;
+
+/// Graph points priced per batch when they are streamed to a callback.
+inline constexpr std::size_t kGraphWindowPoints = 16;
+
+/**
+ * @struct curve_request
+ * @brief Range and budgets of one look_back::sample_curve() call.
+ */
+struct curve_request
+{
+    curve_axis axis;
+    curve_quantity quantity;
+    double lo;                         ///< First abscissa (> 0)
+    double hi;                         ///< Last abscissa (> lo)
+    std::size_t initial_points = 21;   ///< Uniform starting grid (>= 3)
+    std::size_t max_points = 81;       ///< Point budget, including the starting grid
+    double seconds = 0.0;              ///< Wall-clock budget for refinement (0 = none)
+    std::uint64_t N = 0;               ///< Pairs per revaluation (0 = kCurvePairs, h-based for Greeks)
+    double tolerance = 0.0;            ///< Target interpolation and Monte Carlo error (0 = spend the budget)
+};
+
+/** @brief One sampled point of a curve and the standard error of its ordinate. */
+struct curve_point
+{
+    double x;
+    double y;
+    double se;
+};
+
 
 /**
  * @class look_back
@@ -76,14 +350,19 @@ typedef std::vector<double> vect;
  *
  * @warning
  * The Monte Carlo cost can be high, as the simulation of the running maximum
- * is performed at each time step and for each path.
+ * is performed at each time step and for each path. *
+ * @par Thread safety
+ * All member functions may run concurrently on one object, setters included: the settings
+ * changed after construction (engine, estimator, model, surface, sample store, observed
+ * extremum, tick cache) are replaced as one snapshot, and each call works on the snapshot
+ * it started with. Only copying or assigning a contract must not race with its setters.
+ * Concurrent simulations share the core budget of core_governor.
  */
 
 class look_back
 {
     
 private:
-    mutable std::mt19937_64 gen_;
     double S0_;
     
     Date value_date_;
@@ -93,6 +372,29 @@ private:
     double interest_rate_;
     char option_;
     double h_;
+
+    /// Settings changed after construction; never modified in place once published.
+    struct settings
+    {
+        pricing_engine engine = pricing_engine::automatic;
+        mc_estimator estimator = mc_estimator::antithetic;
+        std::optional<heston_params> heston;
+        std::shared_ptr<const price_surface> surface;
+        std::shared_ptr<const sample_store> samples;
+        std::optional<double> observed;
+        std::shared_ptr<const tick_revaluator> ticks;
+    };
+
+    /// Guards settings_; a copied contract gets a mutex of its own.
+    struct settings_mutex : std::mutex
+    {
+        settings_mutex() = default;
+        settings_mutex(const settings_mutex&) {}
+        settings_mutex& operator=(const settings_mutex&) { return *this; }
+    };
+
+    mutable settings_mutex settings_mutex_;
+    std::shared_ptr<const settings> settings_ = std::make_shared<const settings>();
     
 public:
     /**
@@ -146,11 +448,215 @@ public:
      * This implementation is a direct numerical realization of a published
      * Monte Carlo method and does not claim originality with respect to the
      * underlying mathematical results.
+     *
+     * @note
+     * When active_engine() is pricing_engine::analytic, the closed form is returned
+     * instead and `N` is ignored. estimate(), price_batch() and their variants always
+     * simulate.
+     */
+
+    double price(double S, double sigma, double interest_rate, double maturity, std::uint64_t N = 5000000) const;
+
+    /**
+     * @brief Prices several market points in a single parallel pass.
+     *
+     * @details
+     * Every point is split into fixed-size chunks of paths, each chunk drawing from its
+     * own deterministic RNG substream. All (point, chunk) pairs are scheduled together,
+     * so no thread idles between points, and points with the same N share the same
+     * draws (common random numbers for bumped revaluations).
+     *
+     * @param points Market points to price.
+     * @return Discounted Monte Carlo prices, in the order of `points`.
+     * @throws Invalid_Parameters if a point requests zero paths.
+     */
+    std::vector<double> price_batch(const std::vector<mc_point>& points) const;
+
+    /** @brief As price(), also returning the standard error of the estimate. */
+    mc_estimate estimate(double S, double sigma, double interest_rate, double maturity, std::uint64_t N = 5000000) const;
+
+    /**
+     * @brief As price_batch(), also returning standard errors.
+     * @param chunk_prices If not null, receives for each point the discounted price of each of
+     *        its chunks. Chunk k of every point draws from the same substream, so these are
+     *        paired replicates across points (batch means).
      */
+    std::vector<mc_estimate> estimate_batch(const std::vector<mc_point>& points,
+                                            std::vector<std::vector<double>>* chunk_prices = nullptr) const
+    { return estimate_batch(*snapshot(), points, chunk_prices); }
 
-    double price(double S, double sigma, double interest_rate, double maturity, unsigned int N = 5000000) const;
+    /**
+     * @brief Prices like estimate(), reporting the running estimate every `every` paths.
+     *
+     * @details
+     * Paths are simulated in rounds of `every` (rounded up to whole chunks). After each
+     * round but the last, `on_progress` receives the estimate so far; returning false stops
+     * the run, and the estimate from the paths completed is returned. A run that is not
+     * stopped returns exactly the value of estimate().
+     *
+     * @param every Paths between two reports.
+     * @param on_progress Callback (may be null).
+     * @param context Opaque pointer passed back to the callback.
+     */
+    mc_estimate estimate_progressive(double S, double sigma, double interest_rate, double maturity, std::uint64_t N,
+                                     std::uint64_t every, progress_fn on_progress, void* context = nullptr) const;
+
+    /**
+     * @brief Prices like estimate(), persisting progress to a checkpoint file every `every` paths.
+     * @details
+     * If `path` holds a checkpoint of the same run (same inputs, seed and kernel), the run
+     * resumes after the last saved chunk; otherwise it starts from the beginning. The result
+     * is exactly the value of estimate(), however many times the run was interrupted. The
+     * checkpoint is removed when the run completes.
+     * @throws std::runtime_error if `path` holds a checkpoint of a different run or on I/O failure.
+     */
+    mc_estimate estimate_checkpointed(double S, double sigma, double interest_rate, double maturity, std::uint64_t N,
+                                      const std::string& path, std::uint64_t every = 10000000) const;
+
+    /**
+     * @brief Prices within a wall-clock budget, returning the best estimate reached.
+     * @details
+     * Chunks are simulated in windows of one chunk per thread until another window would
+     * no longer fit in `seconds` (judged from the previous window, with a safety margin),
+     * or until `max_N` pairs are done. The first window always runs, so the budget cannot
+     * be met below the time of one chunk. The estimate equals estimate() with N set to the
+     * number of pairs reported in `paths`.
+     * @param seconds Time budget, measured from the call.
+     * @param max_N Upper bound on the antithetic pairs simulated.
+     */
+    mc_estimate estimate_within(double S, double sigma, double interest_rate, double maturity, double seconds,
+                                std::uint64_t max_N = std::numeric_limits<std::uint64_t>::max()) const;
+
+    /**
+     * @brief Computes price and all Greeks in one scheduling pass.
+     *
+     * @details
+     * The revaluations required by every finite-difference Greek are collected,
+     * duplicates are removed (delta and gamma share S0 +/- 2h, gamma and price share S0
+     * when N matches) and the remaining points are priced by price_batch().
+     *
+     * @param N Number of Monte Carlo paths used for the price itself.
+     *
+     * @note With the analytic engine everything comes from the closed form (SE = 0).
+     */
+    risk_line risk_report(std::uint64_t N = 5000000) const;
     
-    /** @brief Delta via central finite difference in spot. */
+    /**
+     * @brief Selects the engine used by price(), the Greeks, risk_report() and the graphs.
+     * @throws Invalid_Parameters if `engine` is analytic and the contract does not fit it,
+     *         or if `engine` is surface and no surface is attached (or the model is Heston).
+     */
+    void set_engine(pricing_engine engine);
+
+    /**
+     * @brief Attaches a precomputed normalized surface (shared, read-only) for pricing_engine::surface.
+     * @details Pass null to detach; a contract using the surface engine then reverts to automatic.
+     */
+    void set_surface(std::shared_ptr<const price_surface> surface);
+
+    /** @brief Spot at the valuation date. */
+    double S0() const { return S0_; }
+    /** @brief Valuation date. */
+    const Date& value_date() const { return value_date_; }
+    /** @brief Time to maturity (year fraction). */
+    double ttm() const { return ttm_; }
+    /** @brief Volatility. */
+    double sigma() const { return sigma_; }
+    /** @brief Risk-free rate. */
+    double interest_rate() const { return interest_rate_; }
+    /** @brief Option type ('c' or 'p'). */
+    char option() const { return option_; }
+
+    /**
+     * @brief Switches the Monte Carlo dynamics to Heston stochastic volatility.
+     * @details sigma becomes the initial volatility. Prices, Greeks, risk_report() and the
+     * graphs then simulate with the Heston engine; the estimator setting applies to the
+     * GBM engine only, and the analytic engine no longer applies.
+     * @throws Invalid_Parameters on invalid parameters or if the analytic engine is selected.
+     */
+    void set_heston(const heston_params& params);
+
+    /** @brief Returns to flat-volatility (GBM) dynamics. */
+    void set_black_scholes();
+
+    /** @brief Heston parameters, if the contract uses that model. */
+    std::optional<heston_params> heston() const { return snapshot()->heston; }
+
+    /** @brief Engine requested with set_engine() (automatic by default). */
+    pricing_engine engine() const { return snapshot()->engine; }
+
+    /**
+     * @brief Selects the Monte Carlo estimator used by every simulation of this contract.
+     * @details The draws are the same for all estimators; only how they are turned into
+     * payoffs changes. Use estimate_f32_bias() before switching to antithetic_f32.
+     */
+    void set_estimator(mc_estimator estimator);
+
+    /** @brief Estimator selected with set_estimator() (antithetic by default). */
+    mc_estimator estimator() const { return snapshot()->estimator; }
+
+    /**
+     * @brief Attaches a store of precomputed draws (see Sample_Store.h); null detaches.
+     * @details GBM runs of at most `samples->pairs()` pairs then read their draws instead of
+     * generating them, with identical results. Other runs simulate as usual.
+     */
+    void set_sample_store(std::shared_ptr<const sample_store> samples);
+
+    /** @brief Store attached with set_sample_store(), if any. */
+    std::shared_ptr<const sample_store> samples() const { return snapshot()->samples; }
+
+    /**
+     * @brief Makes the contract seasoned: `extremum` is the running minimum (call) or maximum
+     *        (put) observed between the trade date and the valuation date.
+     * @details The payoff becomes S_T - min(extremum, future minimum) for the call and
+     * max(extremum, future maximum) - S_T for the put. The extremum is a fixed level: spot
+     * bumps of the Greeks and graphs do not move it. An extremum on the far side of the spot
+     * is already superseded by the spot itself. The surface engine does not apply.
+     * @throws Invalid_Parameters unless `extremum` is positive and finite.
+     */
+    void set_observed_extremum(double extremum);
+
+    /** @brief Returns to a newly issued contract (extremum starting at the spot). */
+    void clear_observed_extremum();
+
+    /** @brief Extremum set with set_observed_extremum(), if the contract is seasoned. */
+    std::optional<double> observed_extremum() const { return snapshot()->observed; }
+
+    /**
+     * @brief Simulates `N` pairs at the baseline sigma, rate and maturity and keeps their
+     *        spot-independent part, so tick() can revalue at a new spot without simulating.
+     * @details See Tick_Revaluator.h. The cache follows later changes of the observed
+     * extremum but not of the model: set_heston() drops it.
+     * @throws Invalid_Parameters under the Heston model or if N = 0.
+     */
+    void prepare_ticks(uint64_t N);
+
+    /**
+     * @brief Monte Carlo price and pathwise delta at spot `S` from the prepare_ticks() cache,
+     *        in O(log N).
+     * @throws Invalid_Parameters if prepare_ticks() has not been called or S is not positive.
+     */
+    tick_quote tick(double S) const;
+
+    /**
+     * @brief Validation of the single-precision kernel against the double kernel.
+     * @details Runs both kernels on the same draws and returns the discounted mean of
+     * (float payoff - double payoff) as `price`, with its standard error. Thanks to the
+     * common draws the SE is tiny, so a bias well below the pricing SE can be resolved.
+     */
+    mc_estimate estimate_f32_bias(double S, double sigma, double interest_rate, double maturity, std::uint64_t N) const;
+
+    /**
+     * @brief True if the closed form applies to this contract.
+     * @details Requires flat GBM dynamics with continuous monitoring of the extremum,
+     * i.e. no Heston model set.
+     */
+    bool analytic_applicable() const { return analytic_applicable(*snapshot()); }
+
+    /** @brief Engine actually used: monte_carlo, analytic or surface (automatic is resolved). */
+    pricing_engine active_engine() const { return active_engine(*snapshot()); }
+
+    /** @brief Delta at spot `S` via central finite difference in spot (closed form when direct). */
     double delta(double S) const;
 
     /** @brief Theta via central finite difference in maturity (uses a 3-day bump). */
@@ -171,6 +677,113 @@ public:
     /** @brief Generates (S, delta(S)) points for plotting. */
     std::array<vect,2> graphic_delta(double dx) const;
 
+    /**
+     * @brief Number of points produced by graphic_price() / graphic_delta() for step `dx`.
+     * @details The grid is S_i = i dx S0 for i >= 1 while S_i < 2 S0 (S = 0 carries no
+     * information); no simulation is run.
+     * @throws Invalid_Parameters if dx is not positive.
+     */
+    std::size_t graphic_size(double dx) const;
+
+    /**
+     * @brief Writes (S, price(S)) points directly into caller buffers.
+     *
+     * @details
+     * Only the first `max_len` grid points are priced, on common random numbers. Without
+     * `on_point` they form one batch. With it, they are priced in windows of
+     * kGraphWindowPoints, and `on_point` is invoked for each point of a window, in order,
+     * as soon as the window is done; the values are the same either way.
+     *
+     * @return Number of points written.
+     * @throws Invalid_Parameters if dx is not positive.
+     */
+    std::size_t graphic_price(double dx, double* x_out, double* y_out, std::size_t max_len,
+                              graph_point_fn on_point = nullptr, void* context = nullptr) const;
+
+    /** @brief Writes (S, delta(S)) points directly into caller buffers (see graphic_price()). */
+    std::size_t graphic_delta(double dx, double* x_out, double* y_out, std::size_t max_len,
+                              graph_point_fn on_point = nullptr, void* context = nullptr) const;
+
+    /**
+     * @brief Samples price, delta, gamma or vega against spot, volatility or maturity.
+     *
+     * @details
+     * The other parameters stay at the baseline. The starting grid is priced in one batch on
+     * common random numbers (or in closed form when the engine is direct), then refined in
+     * rounds: intervals whose estimated interpolation error h^2 |y''| / 8 exceeds both the
+     * tolerance and its own Monte Carlo noise get a midpoint, largest errors first. With a
+     * tolerance, points whose standard error exceeds it are also re-priced with more paths
+     * (up to 16x). Refinement stops when the point or time budget would be exceeded, or
+     * when nothing is left to refine.
+     *
+     * The standard error of a Greek is taken from batch means over the substreams its
+     * stencil points share, so it accounts for their common random numbers. Below
+     * kCurveMinBatches substreams it falls back to the bound that ignores this correlation.
+     *
+     * @return Points sorted by abscissa.
+     * @throws Invalid_Parameters on an invalid range or budget.
+     */
+    std::vector<curve_point> sample_curve(const curve_request& request) const;
+
+private:
+    /** @brief Current settings; the caller keeps them alive however the setters run. */
+    std::shared_ptr<const settings> snapshot() const
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex_);
+        return settings_;
+    }
+
+    /**
+     * @brief Publishes a copy of the settings modified by `change`. Setters are serialized,
+     *        so `change` may validate against the settings it modifies.
+     */
+    template<class Change>
+    void update(Change change)
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex_);
+        settings next = *settings_;
+        change(next);
+        settings_ = std::make_shared<const settings>(std::move(next));
+    }
+
+    bool analytic_applicable(const settings& s) const;
+    pricing_engine active_engine(const settings& s) const;
+    std::vector<mc_estimate> estimate_batch(const settings& s, const std::vector<mc_point>& points,
+                                            std::vector<std::vector<double>>* chunk_prices = nullptr) const;
+
+    /** @brief Baseline market point of the contract, with `N` pairs. */
+    mc_point baseline(std::uint64_t N = 5000000) const { return {S0_, sigma_, interest_rate_, ttm_, N}; }
+
+    /**
+     * @brief Price and Greeks without simulation, if the active engine provides them at `at`:
+     *        the closed form, or the surface when the point lies on its grid.
+     */
+    std::optional<risk_line> direct_risk(const settings& s, const mc_point& at) const;
+
+    /** @brief direct_risk() at the baseline point. */
+    std::optional<risk_line> direct_risk(const settings& s) const { return direct_risk(s, baseline()); }
+
+    /**
+     * @brief Appends the revaluations needed by `m` around `at` to `points` (reusing
+     *        identical ones) and returns the stencil combining their prices.
+     * @details risk_measure::price uses `at.N` paths. Greeks use `greek_N`, or their own
+     *          h-based N = 1/h^4 when it is 0. Spot and volatility bumps are shortened to half
+     *          the bumped value when they would reach zero.
+     * @throws Invalid_Parameters if the h-based N is needed and 1/h^4 lies outside [1, 2^64).
+     */
+    greek_stencil stencil(risk_measure m, const mc_point& at, std::vector<mc_point>& points, std::uint64_t greek_N = 0) const;
+
+    /**
+     * @brief Evaluates `quantity` at the abscissas `x` along `axis`, with `N[i]` pairs for x[i]
+     *        (0 = kCurvePairs for prices, h-based for Greeks), in one batch.
+     */
+    std::vector<curve_point> evaluate_curve(const settings& s, curve_axis axis, curve_quantity quantity,
+                                            const std::vector<double>& x, const std::vector<std::uint64_t>& N) const;
+
+    /** @brief Body of graphic_price() and graphic_delta(), with `N` pairs per point (0 = h-based). */
+    std::size_t graph(curve_quantity quantity, std::uint64_t N, double dx, double* x_out, double* y_out,
+                      std::size_t max_len, graph_point_fn on_point, void* context) const;
+
 };
 
 /** @} */ // endgroup LB_Core
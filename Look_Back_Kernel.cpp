@@ -0,0 +1,193 @@
+/**
+ * @file Look_Back_Kernel.cpp
+ * @brief ISA variants of the path kernel and their CPUID-based dispatch.
+ */
+
+#include "Look_Back_Kernel.h"
+#include "Vector_Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    /// Shared body; inlined into each variant so it is compiled, and vectorized, for that variant's target.
+    LB_ALWAYS_INLINE void path_kernel_body(const path_kernel_params& k, const double* Z, const double* U1,
+                                           const double* U2, double* pair, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double log_simulation_plus  = k.logs + k.mu - k.vol * Z[i];
+            const double log_simulation_minus = k.logs + k.mu + k.vol * Z[i];
+
+            const double d1 = log_simulation_plus  - k.logs;
+            const double d2 = log_simulation_minus - k.logs;
+
+            // both terms are non-negative (log(1 - U) < 0), so no clamp before the root: a
+            // constant arm there would keep GCC from if-converting the loop below AVX-512
+            const double rad1 = d1*d1 - k.var2 * vm::log(1.0 - U1[i]);
+            const double rad2 = d2*d2 - k.var2 * vm::log(1.0 - U2[i]);
+
+            // min(bound, extremum) for the call, max(bound, extremum) for the put
+            const double extremum_plus  = k.sign * std::min(k.sign * vm::exp(0.5*(k.logs + log_simulation_plus ) + k.side*vm::sqrt(rad1)), k.sign * k.bound);
+            const double extremum_minus = k.sign * std::min(k.sign * vm::exp(0.5*(k.logs + log_simulation_minus) + k.side*vm::sqrt(rad2)), k.sign * k.bound);
+
+            pair[i] = k.sign * ((vm::exp(log_simulation_plus)  - extremum_plus)
+                              + (vm::exp(log_simulation_minus) - extremum_minus));
+        }
+    }
+
+    /// Single-precision body, in log-price relative to the spot; narrows the draws as it reads them.
+    LB_ALWAYS_INLINE void path_kernel_f32_body(const path_kernel_params& k, const double* Z, const double* U1,
+                                               const double* U2, double* pair, std::size_t n)
+    {
+        const float mu = static_cast<float>(k.mu);
+        const float vol = static_cast<float>(k.vol);
+        const float var2 = static_cast<float>(k.var2);
+        const float side = static_cast<float>(k.side);
+        const float sign = static_cast<float>(k.sign);
+        const float bound = static_cast<float>(k.sign * k.bound * std::exp(-k.logs)); // signed, per unit of spot
+        const double scale = k.sign * std::exp(k.logs);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const float z = static_cast<float>(Z[i]);
+            // 1 - U is formed in double, so it stays a positive normal float however close U is to 1
+            const float v1 = static_cast<float>(1.0 - U1[i]);
+            const float v2 = static_cast<float>(1.0 - U2[i]);
+
+            const float x_plus  = mu - vol * z;
+            const float x_minus = mu + vol * z;
+
+            const float rad1 = x_plus*x_plus   - var2 * vm::log(v1);
+            const float rad2 = x_minus*x_minus - var2 * vm::log(v2);
+
+            const float extremum_plus  = sign * std::min(sign * vm::exp(0.5f*x_plus  + side*vm::sqrt(rad1)), bound);
+            const float extremum_minus = sign * std::min(sign * vm::exp(0.5f*x_minus + side*vm::sqrt(rad2)), bound);
+
+            pair[i] = scale * static_cast<double>((vm::exp(x_plus) - extremum_plus) + (vm::exp(x_minus) - extremum_minus));
+        }
+    }
+
+    void path_kernel_f32_baseline(const path_kernel_params& k, const double* Z, const double* U1,
+                                  const double* U2, double* pair, std::size_t n)
+    {
+        path_kernel_f32_body(k, Z, U1, U2, pair, n);
+    }
+
+    void path_kernel_baseline(const path_kernel_params& k, const double* Z, const double* U1,
+                              const double* U2, double* pair, std::size_t n)
+    {
+        path_kernel_body(k, Z, U1, U2, pair, n);
+    }
+
+#ifdef LB_KERNEL_X86_DISPATCH
+    __attribute__((target("avx2,fma")))
+    void path_kernel_avx2(const path_kernel_params& k, const double* Z, const double* U1,
+                          const double* U2, double* pair, std::size_t n)
+    {
+        path_kernel_body(k, Z, U1, U2, pair, n);
+    }
+
+    __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+    void path_kernel_avx512(const path_kernel_params& k, const double* Z, const double* U1,
+                            const double* U2, double* pair, std::size_t n)
+    {
+        path_kernel_body(k, Z, U1, U2, pair, n);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void path_kernel_f32_avx2(const path_kernel_params& k, const double* Z, const double* U1,
+                              const double* U2, double* pair, std::size_t n)
+    {
+        path_kernel_f32_body(k, Z, U1, U2, pair, n);
+    }
+
+    __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+    void path_kernel_f32_avx512(const path_kernel_params& k, const double* Z, const double* U1,
+                                const double* U2, double* pair, std::size_t n)
+    {
+        path_kernel_f32_body(k, Z, U1, U2, pair, n);
+    }
+#endif
+
+    /// Best variant the CPU supports.
+    kernel_isa detect_isa()
+    {
+#ifdef LB_KERNEL_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+            return kernel_isa::avx512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return kernel_isa::avx2;
+#endif
+        return kernel_isa::baseline;
+    }
+
+    kernel_isa select_isa()
+    {
+        const kernel_isa best = detect_isa();
+        const char* env = std::getenv("LB_KERNEL_ISA");
+        if (!env)
+            return best;
+
+        kernel_isa wanted = best;
+        if (std::strcmp(env, "baseline") == 0 || std::strcmp(env, "sse2") == 0) wanted = kernel_isa::baseline;
+        else if (std::strcmp(env, "avx2") == 0)                                  wanted = kernel_isa::avx2;
+        else if (std::strcmp(env, "avx512") == 0)                                wanted = kernel_isa::avx512;
+
+        // never run a variant the CPU cannot execute
+        return static_cast<int>(wanted) <= static_cast<int>(best) ? wanted : best;
+    }
+}
+
+kernel_isa active_kernel_isa()
+{
+    static const kernel_isa isa = select_isa();
+    return isa;
+}
+
+path_kernel_fn active_path_kernel()
+{
+    static const path_kernel_fn fn = [] {
+        switch (active_kernel_isa())
+        {
+#ifdef LB_KERNEL_X86_DISPATCH
+            case kernel_isa::avx512: return &path_kernel_avx512;
+            case kernel_isa::avx2:   return &path_kernel_avx2;
+#endif
+            default:                 return &path_kernel_baseline;
+        }
+    }();
+    return fn;
+}
+
+path_kernel_fn active_path_kernel_f32()
+{
+    static const path_kernel_fn fn = [] {
+        switch (active_kernel_isa())
+        {
+#ifdef LB_KERNEL_X86_DISPATCH
+            case kernel_isa::avx512: return &path_kernel_f32_avx512;
+            case kernel_isa::avx2:   return &path_kernel_f32_avx2;
+#endif
+            default:                 return &path_kernel_f32_baseline;
+        }
+    }();
+    return fn;
+}
+
+const char* kernel_isa_name(kernel_isa isa)
+{
+    switch (isa)
+    {
+        case kernel_isa::avx512: return "avx512";
+        case kernel_isa::avx2:   return "avx2";
+        default:                 return "baseline";
+    }
+}
+
+// resolve the variant at library load rather than inside the first timed pricing
+static const path_kernel_fn g_kernel_at_load = active_path_kernel();
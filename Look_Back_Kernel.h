@@ -0,0 +1,93 @@
+/**
+ * @file Look_Back_Kernel.h
+ * @brief Per-path pricing kernel compiled for several instruction sets, selected at load time.
+ *
+ * @details
+ * The Monte Carlo loop is split in two phases: random draws are generated into small
+ * blocks, then the kernel below turns each block of (Z, U1, U2) into antithetic payoff
+ * pairs. The kernel is branch-free over contiguous arrays and takes exp, log and sqrt
+ * from Vector_Math.h rather than the C library, so the compiler vectorizes it (at -O3)
+ * in each of the variants it is built in:
+ * - baseline (SSE2 on x86-64: 2 doubles / 4 floats per instruction; the default target elsewhere),
+ * - AVX2 + FMA (4 doubles / 8 floats),
+ * - AVX-512 (8 doubles / 16 floats).
+ *
+ * The best variant supported by the CPU is chosen once, on first use, via CPUID. The
+ * environment variable `LB_KERNEL_ISA` (`baseline`, `avx2`, `avx512`) forces a lower
+ * variant; a request above what the CPU supports is ignored. Variants using FMA may
+ * differ from the baseline in the last bits of the result.
+ *
+ * A single-precision kernel (mc_estimator::antithetic_f32) is built for the same variants,
+ * with the same signature. It narrows the double draws to float inside its loop, works in
+ * log-price relative to the spot, so no large offset is carried in float, and widens each
+ * pair payoff back to double, scaled like the double kernel's. Its vector loops hold twice
+ * as many lanes as the double kernel's (4/8/16 floats for baseline/AVX2/AVX-512).
+ *
+ * The Heston engine builds its tile step for the same variants and follows the same
+ * selection (Heston_Engine.h).
+ *
+ * Seasoned contracts cap the simulated extremum with the one already observed
+ * (path_kernel_params::bound), as min/max(bound, path extremum) written sign-symmetric so
+ * the loop stays branch-free.
+ */
+
+#ifndef Look_Back_Kernel_h
+#define Look_Back_Kernel_h
+
+#include <cstddef>
+
+// shared by the files that build ISA variants (Look_Back_Kernel.cpp, Heston_Engine.cpp)
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #define LB_KERNEL_X86_DISPATCH 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define LB_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+  #define LB_ALWAYS_INLINE inline
+#endif
+
+/** @brief Instruction-set variants of the path kernel. */
+enum class kernel_isa : int
+{
+    baseline = 0,
+    avx2 = 1,
+    avx512 = 2
+};
+
+/** @brief Contract/market constants of one revaluation, precomputed for the kernel. */
+struct path_kernel_params
+{
+    double logs;  ///< log(S)
+    double mu;    ///< (r - sigma^2/2) T
+    double vol;   ///< sigma sqrt(T)
+    double var2;  ///< 2 sigma^2 T
+    double side;  ///< -0.5 for the running minimum (call), +0.5 for the maximum (put)
+    double sign;  ///< +1 (call) or -1 (put)
+    double bound; ///< Extremum observed before the valuation date: +inf (call) or 0 (put) if none
+};
+
+/**
+ * @brief Kernel signature: writes the undiscounted payoff sum of each antithetic pair.
+ * @details `U1`, `U2` must already be clamped away from 0 and 1.
+ */
+typedef void (*path_kernel_fn)(const path_kernel_params& k, const double* Z, const double* U1,
+                               const double* U2, double* pair, std::size_t n);
+
+/** @brief Kernel variant selected for this process. */
+path_kernel_fn active_path_kernel();
+
+/**
+ * @brief Single-precision kernel for the same instruction set as active_path_kernel().
+ * @details Takes the same double draws (clamped away from 0 and 1 in double) and writes the
+ * same quantity, computed in float.
+ */
+path_kernel_fn active_path_kernel_f32();
+
+/** @brief Instruction set of active_path_kernel(). */
+kernel_isa active_kernel_isa();
+
+/** @brief Printable name of a variant ("baseline", "avx2", "avx512"). */
+const char* kernel_isa_name(kernel_isa isa);
+
+#endif /* Look_Back_Kernel_h */
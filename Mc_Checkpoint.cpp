@@ -0,0 +1,95 @@
+/**
+ * @file Mc_Checkpoint.cpp
+ * @brief POSIX implementation of checkpoint load/save.
+ */
+
+#include "Mc_Checkpoint.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Look_Back_Kernel.h"
+
+namespace
+{
+    constexpr char kMagic[8] = {'L', 'B', 'C', 'K', 'P', 'T', '0', '1'};
+
+    std::runtime_error io_error(const std::string& what, const std::string& path)
+    {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+}
+
+mc_checkpoint mc_checkpoint::start(char option, mc_estimator estimator, double observed, const mc_point& p)
+{
+    mc_checkpoint c;
+    std::memset(&c, 0, sizeof(c));
+    std::memcpy(c.magic, kMagic, sizeof(kMagic));
+    c.version = kVersion;
+    c.kernel = static_cast<std::uint32_t>(active_kernel_isa());
+    c.seed = kMcSeed;
+    c.chunk_paths = kMcChunkPaths;
+    c.option = option;
+    c.estimator = static_cast<std::uint8_t>(estimator);
+    c.S = p.S;
+    c.sigma = p.sigma;
+    c.interest_rate = p.interest_rate;
+    c.ttm = p.ttm;
+    c.N = p.N;
+    c.observed = observed;
+    return c;
+}
+
+bool mc_checkpoint::matches(char option, mc_estimator estimator, double observed, const mc_point& p) const
+{
+    // the kernel is part of the run: vector and scalar kernels may round differently
+    return seed == kMcSeed && chunk_paths == kMcChunkPaths
+        && kernel == static_cast<std::uint32_t>(active_kernel_isa())
+        && this->option == option && this->estimator == static_cast<std::uint8_t>(estimator) && S == p.S && sigma == p.sigma
+        && interest_rate == p.interest_rate && ttm == p.ttm && N == p.N && this->observed == observed;
+}
+
+bool load_checkpoint(const std::string& path, mc_checkpoint& out)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+            return false;
+        throw io_error("Cannot open checkpoint", path);
+    }
+
+    const ssize_t got = ::read(fd, &out, sizeof(out));
+    ::close(fd);
+    if (got < 0)
+        throw io_error("Cannot read checkpoint", path);
+    if (got != static_cast<ssize_t>(sizeof(out)) || std::memcmp(out.magic, kMagic, sizeof(kMagic)) != 0
+        || out.version != mc_checkpoint::kVersion)
+        throw std::runtime_error("'" + path + "' is not a supported checkpoint file.");
+    return true;
+}
+
+void save_checkpoint(const std::string& path, const mc_checkpoint& c)
+{
+    const std::string tmp = path + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw io_error("Cannot create checkpoint", tmp);
+
+    const bool ok = ::write(fd, &c, sizeof(c)) == static_cast<ssize_t>(sizeof(c)) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok)
+        throw io_error("Cannot write checkpoint", tmp);
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw io_error("Cannot replace checkpoint", path);
+}
+
+void remove_checkpoint(const std::string& path)
+{
+    ::unlink(path.c_str());
+}
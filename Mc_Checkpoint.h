@@ -0,0 +1,76 @@
+/**
+ * @file Mc_Checkpoint.h
+ * @brief Small checkpoint file for resuming a long Monte Carlo run.
+ *
+ * @details
+ * A run is fully described by its inputs and by the index of the next chunk to simulate:
+ * chunk `k` always draws from substream mc_substream_seed(k), and chunk sums are merged
+ * in chunk order. Persisting the accumulated sums together with that index is therefore
+ * enough to resume a run and reproduce the uninterrupted result bit for bit.
+ *
+ * The file is replaced atomically (write to `path.tmp`, then `rename`), so a crash while
+ * saving leaves the previous checkpoint intact.
+ *
+ * Exceptions:
+ * - I/O failures and malformed files throw `std::runtime_error`.
+ */
+
+#ifndef Mc_Checkpoint_h
+#define Mc_Checkpoint_h
+
+#include <cstdint>
+#include <string>
+
+#include "Look_Back.h"
+
+/** @brief On-disk checkpoint of a single-contract run (native-endian). */
+struct mc_checkpoint
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t kernel;       ///< kernel_isa that produced the sums
+    std::uint64_t seed;
+    std::uint64_t chunk_paths;
+    char option;
+    std::uint8_t estimator;     ///< mc_estimator of the run
+    char reserved[6];
+    double S;
+    double sigma;
+    double interest_rate;
+    double ttm;
+    std::uint64_t N;            ///< Antithetic pairs requested
+    std::uint64_t next_chunk;   ///< First chunk not yet included in the sums
+    std::uint64_t pairs_done;
+    double sum;
+    double sum_c;               ///< Compensation term of `sum`
+    double sum_sq;
+    double sum_sq_c;            ///< Compensation term of `sum_sq`
+    std::uint64_t units;        ///< Independent sample units in the sums
+    double observed;            ///< Observed extremum of a seasoned contract (0 = new)
+
+    static constexpr std::uint32_t kVersion = 4;
+
+    /** @brief Checkpoint at chunk 0 for the given run. */
+    static mc_checkpoint start(char option, mc_estimator estimator, double observed, const mc_point& p);
+
+    /** @brief True if this checkpoint belongs to the run described by the arguments. */
+    bool matches(char option, mc_estimator estimator, double observed, const mc_point& p) const;
+};
+
+/**
+ * @brief Reads `path` into `out`.
+ * @return false if the file does not exist.
+ * @throws std::runtime_error if the file exists but cannot be read or is not a checkpoint.
+ */
+bool load_checkpoint(const std::string& path, mc_checkpoint& out);
+
+/**
+ * @brief Atomically replaces `path` with `c`.
+ * @throws std::runtime_error on I/O failure.
+ */
+void save_checkpoint(const std::string& path, const mc_checkpoint& c);
+
+/** @brief Removes the checkpoint file, if present. */
+void remove_checkpoint(const std::string& path);
+
+#endif /* Mc_Checkpoint_h */
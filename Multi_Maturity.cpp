@@ -0,0 +1,147 @@
+/**
+ * @file Multi_Maturity.cpp
+ * @brief Shared-path simulation of a maturity strip.
+ */
+
+#include "Multi_Maturity.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Numa_Topology.h"
+
+namespace
+{
+    struct leg_sums
+    {
+        double sum = 0.0;
+        double sum_sq = 0.0;
+    };
+}
+
+std::vector<mc_estimate> price_maturity_strip(double S, double sigma, double interest_rate,
+                                              const std::vector<maturity_leg>& legs, std::uint64_t N)
+{
+    if (S <= 0 || sigma <= 0)
+        throw Invalid_Parameters("S and sigma must be positive.");
+    if (N == 0)
+        throw Invalid_Parameters("N must be positive.");
+
+    // distinct maturities and, for each, which extremum must be carried up to it
+    std::vector<double> times;
+    for (const maturity_leg& l : legs)
+    {
+        if (l.option != 'c' && l.option != 'p')
+            throw Invalid_Parameters("Option type can only be 'c' (Call) or 'p' (Put).");
+        if (l.ttm < 0)
+            throw Invalid_Parameters("maturity date < value date in yearFraction.");
+        times.push_back(l.ttm);
+    }
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+
+    const std::size_t K = times.size(), L = legs.size();
+    std::vector<std::size_t> leg_time(L);
+    std::size_t last_min = 0, last_max = 0; // 1 + last interval needing the min / max
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        leg_time[l] = std::lower_bound(times.begin(), times.end(), legs[l].ttm) - times.begin();
+        if (legs[l].option == 'c') last_min = std::max(last_min, leg_time[l] + 1);
+        else                       last_max = std::max(last_max, leg_time[l] + 1);
+    }
+
+    std::vector<double> drift(K), vol(K), var2(K);
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        const double dt = times[k] - (k ? times[k - 1] : 0.0);
+        drift[k] = (interest_rate - 0.5*sigma*sigma)*dt;
+        vol[k] = sigma*std::sqrt(dt);
+        var2[k] = 2.0*sigma*sigma*dt;
+    }
+
+    const uint64_t n_chunks = chunk_count(N);
+    std::vector<leg_sums> partial(n_chunks * L);
+
+    numa_parallel_for(static_cast<long>(n_chunks), [&](long c)
+    {
+        const uint64_t chunk = static_cast<uint64_t>(c);
+        const unsigned int n = std::min<uint64_t>(kMcChunkPaths, N - chunk * kMcChunkPaths);
+
+        // one normal per interval, then the uniforms of the extrema in use
+        mc_substream substream(chunk);
+
+        std::vector<double> Z(K), pair(L);
+        std::vector<double> x(2*K), lo(2*K), hi(2*K); // state at each maturity, for both paths of the pair
+        leg_sums* out = &partial[chunk * L];
+
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            for (std::size_t k = 0; k < K; ++k)
+                Z[k] = substream.normal();
+
+            for (int a = 0; a < 2; ++a)
+            {
+                const double dir = a == 0 ? -1.0 : 1.0; // same sign convention as look_back::price()
+                double xc = 0.0, m = 0.0, M = 0.0;      // log-price relative to S, running extrema
+                for (std::size_t k = 0; k < K; ++k)
+                {
+                    const double xn = xc + drift[k] + dir * vol[k] * Z[k];
+                    const double d = xn - xc;
+                    if (k < last_min)
+                        m = std::min(m, 0.5*(xc + xn) - 0.5*std::sqrt(std::max(0.0, d*d - var2[k]*std::log(1.0 - substream.uniform()))));
+                    if (k < last_max)
+                        M = std::max(M, 0.5*(xc + xn) + 0.5*std::sqrt(std::max(0.0, d*d - var2[k]*std::log(1.0 - substream.uniform()))));
+                    xc = xn;
+                    x[a*K + k] = xc;
+                    lo[a*K + k] = m;
+                    hi[a*K + k] = M;
+                }
+            }
+
+            for (std::size_t l = 0; l < L; ++l)
+            {
+                const std::size_t k = leg_time[l];
+                double v = 0.0;
+                for (int a = 0; a < 2; ++a)
+                    v += legs[l].option == 'c' ? S * (std::exp(x[a*K + k]) - std::exp(lo[a*K + k]))
+                                               : S * (std::exp(hi[a*K + k]) - std::exp(x[a*K + k]));
+                out[l].sum += v;
+                out[l].sum_sq += v * v;
+            }
+        }
+    });
+
+    std::vector<mc_estimate> estimates(L);
+    for (std::size_t l = 0; l < L; ++l)
+    {
+        compensated_sum sum, sum_sq;
+        for (uint64_t c = 0; c < n_chunks; ++c)
+        {
+            sum.add(partial[c * L + l].sum);
+            sum_sq.add(partial[c * L + l].sum_sq);
+        }
+        estimates[l] = make_estimate(std::exp(-interest_rate * legs[l].ttm), sum, sum_sq, N, N);
+    }
+    return estimates;
+}
+
+std::vector<mc_estimate> price_maturity_strip(const std::vector<const look_back*>& contracts, std::uint64_t N)
+{
+    if (contracts.empty())
+        return {};
+
+    const look_back& first = *contracts.front();
+    std::vector<maturity_leg> legs;
+    for (const look_back* c : contracts)
+    {
+        if (c->heston())
+            throw Invalid_Parameters("Maturity strips are simulated under the GBM model only.");
+        if (c->observed_extremum())
+            throw Invalid_Parameters("Maturity strips price newly issued contracts only.");
+        if (c->S0() != first.S0() || c->sigma() != first.sigma() || c->interest_rate() != first.interest_rate()
+            || c->value_date().d_ != first.value_date().d_)
+            throw Invalid_Parameters("Contracts of a maturity strip must share spot, volatility, rate and value date.");
+        legs.push_back({c->ttm(), c->option()});
+    }
+    return price_maturity_strip(first.S0(), first.sigma(), first.interest_rate(), legs, N);
+}
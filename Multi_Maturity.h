@@ -0,0 +1,52 @@
+/**
+ * @file Multi_Maturity.h
+ * @brief Prices lookbacks with different maturities on one underlying from a shared path set.
+ *
+ * @details
+ * Instead of one independent simulation per contract, every path is advanced once through
+ * the sorted set of distinct maturities \f$0 < t_1 < \dots < t_K\f$. On each interval the
+ * log-price increment is Gaussian and the interval extremum is sampled exactly from its
+ * law conditional on the endpoints (the same formula as look_back::price(), Crépey 2013,
+ * Paragraph 6.9.1.1); the running minimum/maximum is carried forward, so at \f$t_k\f$
+ * the path holds the exact triple \f$(X_{t_k}, m_{t_k}, M_{t_k})\f$ for every contract
+ * maturing there.
+ *
+ * Cost grows with paths x distinct maturities, not paths x contracts, and all prices of
+ * the term structure come from the same draws (consistent, common random numbers).
+ *
+ * The Gaussian increments are antithetic (the second path of a pair uses -Z on every
+ * interval); minimum and maximum use independent uniforms, which gives the exact marginal
+ * law needed by calls and puts.
+ */
+
+#ifndef Multi_Maturity_h
+#define Multi_Maturity_h
+
+#include <cstdint>
+#include <vector>
+
+#include "Look_Back.h"
+
+/** @brief One contract of a maturity strip: time to maturity and option type. */
+struct maturity_leg
+{
+    double ttm;
+    char option; ///< 'c' or 'p'
+};
+
+/**
+ * @brief Prices every leg from one set of `N` antithetic path pairs.
+ * @return One estimate per leg, in the order of `legs`.
+ * @throws Invalid_Parameters on invalid market data, option types, negative maturities or N = 0.
+ */
+std::vector<mc_estimate> price_maturity_strip(double S, double sigma, double interest_rate,
+                                              const std::vector<maturity_leg>& legs, std::uint64_t N);
+
+/**
+ * @brief Prices contracts that share spot, volatility, rate and valuation date.
+ * @throws Invalid_Parameters if the contracts do not share the same underlying state, use the
+ *         Heston model or are seasoned.
+ */
+std::vector<mc_estimate> price_maturity_strip(const std::vector<const look_back*>& contracts, std::uint64_t N);
+
+#endif /* Multi_Maturity_h */
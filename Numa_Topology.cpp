@@ -0,0 +1,117 @@
+/**
+ * @file Numa_Topology.cpp
+ * @brief Linux sysfs topology parsing and thread pinning (no-op elsewhere).
+ */
+
+#include "Numa_Topology.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+#ifdef __linux__
+struct numa_pin::saved_affinity
+{
+    cpu_set_t set;
+};
+#else
+struct numa_pin::saved_affinity {};
+#endif
+
+namespace
+{
+    /// Parses a sysfs cpulist such as "0-3,8-11".
+    std::vector<int> parse_cpulist(const std::string& list)
+    {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ','))
+        {
+            if (range.empty() || range == "\n")
+                continue;
+            const std::size_t dash = range.find('-');
+            const int lo = std::atoi(range.c_str());
+            const int hi = dash == std::string::npos ? lo : std::atoi(range.c_str() + dash + 1);
+            for (int c = lo; c <= hi; ++c)
+                cpus.push_back(c);
+        }
+        return cpus;
+    }
+}
+
+const numa_topology& numa_topology::instance()
+{
+    static const numa_topology topo;
+    return topo;
+}
+
+numa_topology::numa_topology()
+{
+#ifdef __linux__
+    const char* env = std::getenv("LB_NUMA");
+    if (!(env && std::strcmp(env, "0") == 0))
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+        for (int node = 0; ; ++node)
+        {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in)
+                break;
+            std::string list;
+            std::getline(in, list);
+
+            std::vector<int> cpus;
+            for (int c : parse_cpulist(list))
+                if (!have_mask || (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)))
+                    cpus.push_back(c);
+
+            // memory-only nodes and nodes outside our cpuset cannot host workers
+            if (!cpus.empty())
+                node_cpus_.push_back(std::move(cpus));
+        }
+    }
+#endif
+    if (node_cpus_.empty())
+        node_cpus_.emplace_back();
+}
+
+numa_pin::numa_pin(const numa_topology& topo, std::size_t node)
+{
+#ifdef __linux__
+    if (node >= topo.nodes() || topo.cpus(node).empty())
+        return;
+
+    auto saved = std::make_unique<saved_affinity>();
+    if (pthread_getaffinity_np(pthread_self(), sizeof(saved->set), &saved->set) != 0)
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : topo.cpus(node))
+        CPU_SET(c, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+        saved_ = std::move(saved);
+#else
+    (void)topo;
+    (void)node;
+#endif
+}
+
+numa_pin::~numa_pin()
+{
+#ifdef __linux__
+    if (saved_)
+        pthread_setaffinity_np(pthread_self(), sizeof(saved_->set), &saved_->set);
+#endif
+}
@@ -0,0 +1,136 @@
+/**
+ * @file Numa_Topology.h
+ * @brief NUMA topology detection and node-aware scheduling of Monte Carlo chunks.
+ *
+ * @details
+ * On multi-socket Linux machines the node layout is read once from
+ * `/sys/devices/system/node` (restricted to the CPUs the process may run on). Other
+ * platforms, or machines with a single node, report one node and the scheduler below
+ * degenerates to a plain OpenMP dynamic loop.
+ *
+ * numa_parallel_for() splits a task range into one contiguous block per node, pins every
+ * OpenMP thread to the CPUs of its node, and lets threads take tasks from their own
+ * node's block first (stealing from other nodes once it is empty). Anything a task
+ * allocates or touches first therefore lands in node-local memory. Thread affinities
+ * are restored before returning, so the caller's thread is left as it was.
+ *
+ * Set the environment variable `LB_NUMA=0` to disable pinning and partitioning.
+ */
+
+#ifndef Numa_Topology_h
+#define Numa_Topology_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <omp.h>
+
+#include "Concurrency_Governor.h"
+
+/** @ingroup LB_Core */
+class numa_topology
+{
+public:
+    /** @brief Topology of the current machine, detected on first use. */
+    static const numa_topology& instance();
+
+    /** @brief Number of nodes (at least 1). */
+    std::size_t nodes() const { return node_cpus_.size(); }
+
+    /** @brief CPUs of `node` (empty when placement is not supported). */
+    const std::vector<int>& cpus(std::size_t node) const { return node_cpus_[node]; }
+
+    /** @brief True if threads are pinned and work is partitioned per node. */
+    bool active() const { return nodes() > 1; }
+
+private:
+    numa_topology();
+
+    std::vector<std::vector<int>> node_cpus_;
+};
+
+/**
+ * @class numa_pin
+ * @brief Pins the calling thread to the CPUs of a node for the lifetime of the object.
+ * @details The previous affinity is restored by the destructor. No-op when unsupported.
+ */
+class numa_pin
+{
+public:
+    numa_pin(const numa_topology& topo, std::size_t node);
+    ~numa_pin();
+
+    numa_pin(const numa_pin&) = delete;
+    numa_pin& operator=(const numa_pin&) = delete;
+
+private:
+    struct saved_affinity;
+    std::unique_ptr<saved_affinity> saved_;
+};
+
+/// Tasks per granted thread in one round of numa_parallel_for().
+inline constexpr long kTasksPerThreadRound = 8;
+
+/**
+ * @brief Runs `task(t)` for every t in [0, n_tasks) with NUMA-aware placement.
+ *
+ * @details
+ * Tasks are expected to be independent and to write their results to distinct slots.
+ * Task `t` is not guaranteed to run on a particular thread, only preferably on the node
+ * owning the block that contains `t`.
+ *
+ * Tasks run in rounds of kTasksPerThreadRound tasks per thread; each round takes a
+ * core_lease, so concurrent calls share the core budget (see Concurrency_Governor.h).
+ */
+template <class Task>
+void numa_parallel_for(long n_tasks, Task&& task)
+{
+    const numa_topology& topo = numa_topology::instance();
+
+    for (long first = 0; first < n_tasks; )
+    {
+        const core_lease lease(n_tasks - first);
+        const int threads = lease.threads();
+        const long count = std::min(n_tasks - first, kTasksPerThreadRound * threads);
+
+        if (!topo.active())
+        {
+            #pragma omp parallel for schedule(dynamic) num_threads(threads)
+            for (long t = first; t < first + count; ++t)
+                task(t);
+        }
+        else
+        {
+            const long nodes = static_cast<long>(topo.nodes());
+            std::vector<std::atomic<long>> next(static_cast<std::size_t>(nodes));
+            for (auto& n : next)
+                n.store(0, std::memory_order_relaxed);
+
+            // contiguous block of the round's tasks owned by each node
+            auto block_begin = [&](long node) { return first + count * node / nodes; };
+
+            #pragma omp parallel num_threads(threads)
+            {
+                const long nt = omp_get_num_threads();
+                const long node = static_cast<long>(omp_get_thread_num()) * nodes / nt;
+                const numa_pin pin(topo, static_cast<std::size_t>(node));
+
+                // own node first, then help the others in round-robin order
+                for (long k = 0; k < nodes; ++k)
+                {
+                    const long victim = (node + k) % nodes;
+                    const long begin = block_begin(victim), size = block_begin(victim + 1) - begin;
+                    for (long i = next[victim].fetch_add(1, std::memory_order_relaxed); i < size;
+                         i = next[victim].fetch_add(1, std::memory_order_relaxed))
+                        task(begin + i);
+                }
+            }
+        }
+        first += count;
+    }
+}
+
+#endif /* Numa_Topology_h */
@@ -0,0 +1,211 @@
+/**
+ * @file Price_Surface.cpp
+ * @brief Catmull–Rom interpolation and POSIX `mmap` loading of price surfaces.
+ */
+
+#include "Price_Surface.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Look_Back.h"
+
+namespace
+{
+    constexpr char kMagic[8] = {'L', 'B', 'S', 'U', 'R', 'F', 'A', 'C'};
+
+    std::runtime_error io_error(const std::string& what, const std::string& path)
+    {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+
+    /// Catmull–Rom weights (value and derivative in t) for the points -1, 0, 1, 2.
+    void catmull_rom(double t, double w[4], double dw[4])
+    {
+        const double t2 = t * t, t3 = t2 * t;
+        w[0] = 0.5 * (-t3 + 2*t2 - t);
+        w[1] = 0.5 * (3*t3 - 5*t2 + 2);
+        w[2] = 0.5 * (-3*t3 + 4*t2 + t);
+        w[3] = 0.5 * (t3 - t2);
+        dw[0] = 0.5 * (-3*t2 + 4*t - 1);
+        dw[1] = 0.5 * (9*t2 - 10*t);
+        dw[2] = 0.5 * (-9*t2 + 8*t + 1);
+        dw[3] = 0.5 * (3*t2 - 2*t);
+    }
+
+    /// Cell index and local coordinate of x on a uniform axis of n points.
+    void locate(double x, double lo, double hi, std::uint64_t n, std::int64_t& cell, double& t, double& step)
+    {
+        step = (hi - lo) / static_cast<double>(n - 1);
+        const double u = (x - lo) / step;
+        cell = std::min<std::int64_t>(static_cast<std::int64_t>(n) - 2, std::max<std::int64_t>(0, static_cast<std::int64_t>(u)));
+        t = u - static_cast<double>(cell);
+    }
+}
+
+surface_sample interpolate_surface(const surface_grid& g, const double* values, double a, double b)
+{
+    std::int64_t ia, ib;
+    double ta, tb, ha, hb;
+    locate(a, g.a_min, g.a_max, g.n_a, ia, ta, ha);
+    locate(b, g.b_min, g.b_max, g.n_b, ib, tb, hb);
+
+    const std::int64_t na = static_cast<std::int64_t>(g.n_a), nb = static_cast<std::int64_t>(g.n_b);
+    // grid value with linear extrapolation one point beyond each edge
+    auto at = [&](std::int64_t i, std::int64_t j) {
+        auto column = [&](std::int64_t jj) {
+            if (i < 0)   return 2*values[jj] - values[nb + jj];
+            if (i >= na) return 2*values[(na - 1)*nb + jj] - values[(na - 2)*nb + jj];
+            return values[i*nb + jj];
+        };
+        if (j < 0)   return 2*column(0) - column(1);
+        if (j >= nb) return 2*column(nb - 1) - column(nb - 2);
+        return column(j);
+    };
+
+    double wa[4], dwa[4], wb[4], dwb[4];
+    catmull_rom(ta, wa, dwa);
+    catmull_rom(tb, wb, dwb);
+
+    surface_sample s{0.0, 0.0, 0.0};
+    for (int k = 0; k < 4; ++k)
+    {
+        double row = 0.0, row_db = 0.0;
+        for (int l = 0; l < 4; ++l)
+        {
+            const double v = at(ia - 1 + k, ib - 1 + l);
+            row += wb[l] * v;
+            row_db += dwb[l] * v;
+        }
+        s.f += wa[k] * row;
+        s.df_da += dwa[k] * row;
+        s.df_db += wa[k] * row_db;
+    }
+    s.df_da /= ha;
+    s.df_db /= hb;
+    return s;
+}
+
+void write_price_surface(const std::string& path, const surface_grid& g, const std::vector<double>& call,
+                         const std::vector<double>& put, double error_bound, std::uint64_t paths,
+                         std::uint32_t estimator)
+{
+    if (g.n_a < 2 || g.n_b < 2 || call.size() != g.size() || put.size() != g.size())
+        throw std::runtime_error("Inconsistent price surface grid.");
+
+    price_surface_header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = price_surface::kVersion;
+    h.estimator = estimator;
+    h.n_a = g.n_a;
+    h.n_b = g.n_b;
+    h.a_min = g.a_min;
+    h.a_max = g.a_max;
+    h.b_min = g.b_min;
+    h.b_max = g.b_max;
+    h.error_bound = error_bound;
+    h.paths = paths;
+    h.seed = kMcSeed;
+
+    // written beside the target and renamed over it: a process that has the old file mapped
+    // keeps reading the old inode instead of pages truncated under it
+    const std::string tmp = path + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f)
+        throw io_error("Cannot create price surface", tmp);
+    const bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1
+                 && std::fwrite(call.data(), sizeof(double), call.size(), f) == call.size()
+                 && std::fwrite(put.data(), sizeof(double), put.size(), f) == put.size()
+                 && std::fflush(f) == 0 && ::fsync(::fileno(f)) == 0;
+    if (std::fclose(f) != 0 || !ok)
+    {
+        const std::runtime_error e = io_error("Cannot write price surface", tmp);
+        ::unlink(tmp.c_str());
+        throw e;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        const std::runtime_error e = io_error("Cannot replace price surface", path);
+        ::unlink(tmp.c_str());
+        throw e;
+    }
+}
+
+price_surface::price_surface(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw io_error("Cannot open price surface", path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(price_surface_header))
+    {
+        ::close(fd);
+        throw std::runtime_error("Price surface '" + path + "' is truncated.");
+    }
+    bytes_ = static_cast<std::size_t>(st.st_size);
+    dev_ = static_cast<std::uint64_t>(st.st_dev);
+    ino_ = static_cast<std::uint64_t>(st.st_ino);
+    mtime_ = static_cast<std::int64_t>(st.st_mtime);
+
+    base_ = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base_ == MAP_FAILED)
+    {
+        base_ = nullptr;
+        throw io_error("Cannot map price surface", path);
+    }
+
+    const price_surface_header* h = header();
+    grid_ = surface_grid{h->n_a, h->n_b, h->a_min, h->a_max, h->b_min, h->b_max};
+    // bound n_a and n_b by the values the file holds before multiplying them
+    const std::uint64_t capacity = (bytes_ - sizeof(price_surface_header)) / (2 * sizeof(double));
+    const bool ok = std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0
+                 && h->version == kVersion
+                 && h->n_a >= 2 && h->n_b >= 2 && h->a_max > h->a_min && h->b_max > h->b_min
+                 && h->n_b <= capacity && h->n_a <= capacity / h->n_b;
+    if (!ok)
+    {
+        ::munmap(base_, bytes_);
+        base_ = nullptr;
+        throw std::runtime_error("'" + path + "' is not a supported price surface.");
+    }
+
+    call_ = reinterpret_cast<const double*>(static_cast<const char*>(base_) + sizeof(price_surface_header));
+    put_ = call_ + grid_.size();
+}
+
+price_surface::~price_surface()
+{
+    if (base_)
+        ::munmap(base_, bytes_);
+}
+
+bool price_surface::is_current(const std::string& path) const
+{
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0
+        && static_cast<std::uint64_t>(st.st_dev) == dev_ && static_cast<std::uint64_t>(st.st_ino) == ino_
+        && static_cast<std::size_t>(st.st_size) == bytes_
+        && static_cast<std::int64_t>(st.st_mtime) == mtime_;
+}
+
+bool price_surface::contains(double a, double b) const
+{
+    return a >= grid_.a_min && a <= grid_.a_max && b >= grid_.b_min && b <= grid_.b_max;
+}
+
+surface_sample price_surface::lookup(char option, double a, double b) const
+{
+    return interpolate_surface(grid_, option == 'c' ? call_ : put_, a, b);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file Price_Surface.h
+ * @brief Precomputed floating-strike prices on a normalized grid, with fast interpolated lookups.
+ *
+ * @details
+ * Under flat GBM a newly issued floating-strike lookback is homogeneous of degree one in
+ * the spot, and its price per unit spot depends on the contract only through
+ * \f$a = \sigma\sqrt{T}\f$ and \f$b = rT\f$ (and the option type):
+ * \f[ P(S, \sigma, r, T) = S\, f(\sigma\sqrt{T},\, rT). \f]
+ * A surface stores \f$f\f$ for calls and puts on a uniform (a, b) grid. Lookups use
+ * bicubic Catmull–Rom interpolation (16 grid values, no search), which also yields
+ * \f$\partial f/\partial a\f$ and \f$\partial f/\partial b\f$ for the Greeks.
+ *
+ * The grid is filled offline by tools/surface_builder.cpp with the Monte Carlo engine.
+ * The file records a bound on |interpolated - true| per unit spot (sampling error plus
+ * measured interpolation error), and points outside the grid are not answered: callers
+ * fall back to simulation (see pricing_engine::surface).
+ *
+ * Layout (native-endian):
+ * @code
+ * [ price_surface_header (256 bytes) ][ call values n_a x n_b ][ put values n_a x n_b ]
+ * @endcode
+ * Values are row-major in a (index ia * n_b + ib).
+ *
+ * write_price_surface() writes `path.tmp` and renames it over `path`, so a process that has
+ * the previous file mapped keeps a consistent (old) surface; price_surface::is_current()
+ * tells it when to map the new one.
+ *
+ * Exceptions:
+ * - I/O failures and malformed files throw `std::runtime_error`.
+ */
+
+#ifndef Price_Surface_h
+#define Price_Surface_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** @brief Uniform normalized grid: a = sigma sqrt(T), b = r T. */
+struct surface_grid
+{
+    std::uint64_t n_a = 0;
+    std::uint64_t n_b = 0;
+    double a_min = 0.0, a_max = 0.0;
+    double b_min = 0.0, b_max = 0.0;
+
+    double a(std::uint64_t i) const { return a_min + (a_max - a_min) * static_cast<double>(i) / static_cast<double>(n_a - 1); }
+    double b(std::uint64_t j) const { return b_min + (b_max - b_min) * static_cast<double>(j) / static_cast<double>(n_b - 1); }
+    std::size_t size() const { return static_cast<std::size_t>(n_a * n_b); }
+};
+
+/** @brief Interpolated value per unit spot and its partial derivatives. */
+struct surface_sample
+{
+    double f;
+    double df_da;
+    double df_db;
+};
+
+/** @brief On-disk header (padded to 256 bytes). */
+struct price_surface_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t estimator;    ///< mc_estimator used by the builder
+    std::uint64_t n_a;
+    std::uint64_t n_b;
+    double a_min, a_max;
+    double b_min, b_max;
+    double error_bound;         ///< Bound on |interpolated - true| per unit spot
+    std::uint64_t paths;        ///< Antithetic pairs per grid point (0 = closed form)
+    std::uint64_t seed;
+    unsigned char padding[256 - 88];
+};
+
+static_assert(sizeof(price_surface_header) == 256, "price_surface_header must be 256 bytes");
+
+/**
+ * @brief Bicubic Catmull–Rom interpolation of `values` (row-major, n_a x n_b) at (a, b).
+ * @details (a, b) must lie inside the grid; the grid needs at least 2 points per axis.
+ */
+surface_sample interpolate_surface(const surface_grid& g, const double* values, double a, double b);
+
+/**
+ * @brief Writes a surface file.
+ * @throws std::runtime_error on I/O failure or inconsistent sizes.
+ */
+void write_price_surface(const std::string& path, const surface_grid& g, const std::vector<double>& call,
+                         const std::vector<double>& put, double error_bound, std::uint64_t paths,
+                         std::uint32_t estimator);
+
+/**
+ * @class price_surface
+ * @brief Read-only, memory-mapped surface. Lookups are lock-free and allocation-free.
+ */
+class price_surface
+{
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    /** @throws std::runtime_error if the file cannot be mapped or has the wrong format. */
+    explicit price_surface(const std::string& path);
+    ~price_surface();
+
+    price_surface(const price_surface&) = delete;
+    price_surface& operator=(const price_surface&) = delete;
+
+    /** @brief True if (a, b) lies inside the grid. */
+    bool contains(double a, double b) const;
+
+    /** @brief Value per unit spot and derivatives for option 'c' or 'p'; (a, b) must be inside. */
+    surface_sample lookup(char option, double a, double b) const;
+
+    /** @brief Bound on the absolute error per unit spot. */
+    double error_bound() const { return header()->error_bound; }
+
+    /** @brief Grid of the surface. */
+    const surface_grid& grid() const { return grid_; }
+
+    /**
+     * @brief True if `path` still names the file this surface mapped (same device, inode,
+     * size and modification time). False once the file has been rebuilt or removed.
+     */
+    bool is_current(const std::string& path) const;
+
+private:
+    const price_surface_header* header() const { return static_cast<const price_surface_header*>(base_); }
+
+    void* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    surface_grid grid_;
+    const double* call_ = nullptr;
+    const double* put_ = nullptr;
+
+    /// Identity of the mapped file, from fstat at load.
+    std::uint64_t dev_ = 0, ino_ = 0;
+    std::int64_t mtime_ = 0;
+};
+
+#endif /* Price_Surface_h */
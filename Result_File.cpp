@@ -0,0 +1,179 @@
+/**
+ * @file Result_File.cpp
+ * @brief POSIX `mmap` implementation of the result file writer and reader.
+ */
+
+#include "Result_File.h"
+
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char kMagic[8] = {'L', 'B', 'R', 'E', 'S', 'U', 'L', 'T'};
+    constexpr std::size_t kColumns = static_cast<std::size_t>(result_column::count);
+
+    std::runtime_error io_error(const std::string& what, const std::string& path)
+    {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+}
+
+result_writer::result_writer(const std::string& path, std::uint64_t capacity, const result_metadata& meta)
+    : capacity_(capacity)
+{
+    bytes_ = sizeof(result_file_header) + kColumns * capacity * sizeof(double);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        throw io_error("Cannot create result file", path);
+
+    if (::ftruncate(fd_, static_cast<off_t>(bytes_)) != 0)
+    {
+        ::close(fd_);
+        throw io_error("Cannot size result file", path);
+    }
+
+    base_ = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base_ == MAP_FAILED)
+    {
+        base_ = nullptr;
+        ::close(fd_);
+        throw io_error("Cannot map result file", path);
+    }
+
+    result_file_header* h = header();
+    std::memcpy(h->magic, kMagic, sizeof(kMagic));
+    h->version = kVersion;
+    h->column_count = static_cast<std::uint32_t>(kColumns);
+    h->capacity = capacity;
+    h->rows = 0;
+    h->seed = meta.seed;
+    h->paths = meta.paths;
+    h->estimator = static_cast<std::uint32_t>(meta.estimator);
+    h->created_unix = static_cast<std::int64_t>(std::time(nullptr));
+    for (std::size_t c = 0; c < kColumns; ++c)
+        h->column_offset[c] = sizeof(result_file_header) + c * capacity * sizeof(double);
+}
+
+result_writer::~result_writer()
+{
+    close();
+}
+
+double* result_writer::column(result_column c) const
+{
+    return reinterpret_cast<double*>(static_cast<char*>(base_) + header()->column_offset[static_cast<std::size_t>(c)]);
+}
+
+bool result_writer::append(const result_row& row)
+{
+    const std::uint64_t i = next_.fetch_add(1, std::memory_order_relaxed);
+    if (i >= capacity_)
+        return false;
+
+    std::memcpy(column(result_column::key) + i, &row.key, sizeof(row.key));
+    column(result_column::price)[i] = row.price;
+    column(result_column::se)[i]    = row.se;
+    column(result_column::delta)[i] = row.delta;
+    column(result_column::gamma)[i] = row.gamma;
+    column(result_column::vega)[i]  = row.vega;
+    column(result_column::rho)[i]   = row.rho;
+    column(result_column::theta)[i] = row.theta;
+    return true;
+}
+
+std::uint64_t result_writer::size() const
+{
+    const std::uint64_t n = next_.load(std::memory_order_relaxed);
+    return n < capacity_ ? n : capacity_;
+}
+
+void result_writer::flush()
+{
+    if (!base_)
+        return;
+    header()->rows = size();
+    ::msync(base_, bytes_, MS_SYNC);
+}
+
+void result_writer::close()
+{
+    if (!base_)
+        return;
+    flush();
+    ::munmap(base_, bytes_);
+    ::close(fd_);
+    base_ = nullptr;
+    fd_ = -1;
+}
+
+result_reader::result_reader(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw io_error("Cannot open result file", path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(result_file_header))
+    {
+        ::close(fd);
+        throw std::runtime_error("Result file '" + path + "' is truncated.");
+    }
+    bytes_ = static_cast<std::size_t>(st.st_size);
+
+    base_ = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base_ == MAP_FAILED)
+    {
+        base_ = nullptr;
+        throw io_error("Cannot map result file", path);
+    }
+
+    const result_file_header* h = header();
+    // bound the capacity before any multiplication, then require the exact writer layout
+    bool ok = std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0
+           && h->version == result_writer::kVersion
+           && h->column_count == kColumns
+           && h->capacity <= (bytes_ - sizeof(result_file_header)) / (kColumns * sizeof(double))
+           && h->rows <= h->capacity;
+    for (std::size_t c = 0; ok && c < kColumns; ++c)
+        ok = h->column_offset[c] == sizeof(result_file_header) + c * h->capacity * sizeof(double);
+    if (!ok)
+    {
+        ::munmap(base_, bytes_);
+        base_ = nullptr;
+        throw std::runtime_error("'" + path + "' is not a supported result file.");
+    }
+}
+
+result_reader::~result_reader()
+{
+    if (base_)
+        ::munmap(base_, bytes_);
+}
+
+result_metadata result_reader::metadata() const
+{
+    result_metadata m;
+    m.seed = header()->seed;
+    m.paths = header()->paths;
+    m.estimator = static_cast<mc_estimator>(header()->estimator);
+    return m;
+}
+
+const std::uint64_t* result_reader::keys() const
+{
+    return reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(base_) + header()->column_offset[0]);
+}
+
+const double* result_reader::column(result_column c) const
+{
+    return reinterpret_cast<const double*>(static_cast<const char*>(base_) + header()->column_offset[static_cast<std::size_t>(c)]);
+}
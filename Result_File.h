@@ -0,0 +1,169 @@
+/**
+ * @file Result_File.h
+ * @brief Versioned, columnar, memory-mapped binary format for batch pricing results.
+ *
+ * @details
+ * A result file holds one row per priced contract: a 64-bit contract key, the price,
+ * its standard error and the Greeks. Columns are stored contiguously, one after the
+ * other, so aggregations over a single column of a multi-GB file read only that column.
+ *
+ * Layout (all values native-endian):
+ * @code
+ * [ result_file_header (4096 bytes) ][ key column ][ price column ] ... [ theta column ]
+ * @endcode
+ * Every column holds `capacity` 8-byte entries; only the first `rows` are meaningful.
+ *
+ * Writers pre-size the file and `mmap` it; rows are reserved with an atomic counter, so
+ * any number of threads can append concurrently without locks. Readers `mmap` the file
+ * read-only and expose raw column pointers (zero copy).
+ *
+ * Exceptions:
+ * - I/O failures and malformed files throw `std::runtime_error`.
+ */
+
+#ifndef Result_File_h
+#define Result_File_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Look_Back.h"
+
+/** @brief Columns of a result file, in storage order. */
+enum class result_column : std::uint32_t
+{
+    key = 0, ///< uint64 contract key
+    price,
+    se,
+    delta,
+    gamma,
+    vega,
+    rho,
+    theta,
+    count
+};
+
+/** @brief Run metadata stored in the file header. */
+struct result_metadata
+{
+    std::uint64_t seed = kMcSeed;
+    std::uint64_t paths = 0;  ///< Paths used for the price column.
+    mc_estimator estimator = mc_estimator::antithetic;
+};
+
+/** @brief One row, as passed to result_writer::append(). */
+struct result_row
+{
+    std::uint64_t key;
+    double price;
+    double se;
+    double delta;
+    double gamma;
+    double vega;
+    double rho;
+    double theta;
+};
+
+/** @brief On-disk file header (padded to one page). */
+struct result_file_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t column_count;
+    std::uint64_t capacity;
+    std::uint64_t rows;
+    std::uint64_t seed;
+    std::uint64_t paths;
+    std::uint32_t estimator;
+    std::uint32_t reserved;
+    std::int64_t created_unix;
+    std::uint64_t column_offset[static_cast<std::size_t>(result_column::count)];
+    unsigned char padding[4096 - 64 - 8*static_cast<std::size_t>(result_column::count)];
+};
+
+static_assert(sizeof(result_file_header) == 4096, "result_file_header must fill one page");
+
+/**
+ * @class result_writer
+ * @brief Creates a result file of fixed capacity and appends rows lock-free.
+ */
+class result_writer
+{
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    /**
+     * @brief Creates (or truncates) `path` with room for `capacity` rows.
+     * @throws std::runtime_error on I/O failure.
+     */
+    result_writer(const std::string& path, std::uint64_t capacity, const result_metadata& meta);
+    ~result_writer();
+
+    result_writer(const result_writer&) = delete;
+    result_writer& operator=(const result_writer&) = delete;
+
+    /**
+     * @brief Appends one row. Safe to call from many threads at once.
+     * @return false if the file is full (the row is dropped).
+     */
+    bool append(const result_row& row);
+
+    /** @brief Number of rows appended so far. */
+    std::uint64_t size() const;
+
+    /**
+     * @brief Publishes the row count and syncs the mapping to disk.
+     * @details Must not run concurrently with append().
+     */
+    void flush();
+
+    /** @brief Flushes and unmaps the file. Called by the destructor if needed. */
+    void close();
+
+private:
+    result_file_header* header() const { return static_cast<result_file_header*>(base_); }
+    double* column(result_column c) const;
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::uint64_t capacity_ = 0;
+    std::atomic<std::uint64_t> next_{0};
+};
+
+/**
+ * @class result_reader
+ * @brief Read-only, zero-copy view of a result file.
+ */
+class result_reader
+{
+public:
+    /** @throws std::runtime_error if the file cannot be mapped or has the wrong format. */
+    explicit result_reader(const std::string& path);
+    ~result_reader();
+
+    result_reader(const result_reader&) = delete;
+    result_reader& operator=(const result_reader&) = delete;
+
+    /** @brief Number of rows. */
+    std::uint64_t size() const { return header()->rows; }
+
+    /** @brief Run metadata stored at write time. */
+    result_metadata metadata() const;
+
+    /** @brief Contract keys (size() entries). */
+    const std::uint64_t* keys() const;
+
+    /** @brief Values of a floating-point column (size() entries). */
+    const double* column(result_column c) const;
+
+private:
+    const result_file_header* header() const { return static_cast<const result_file_header*>(base_); }
+
+    void* base_ = nullptr;
+    std::size_t bytes_ = 0;
+};
+
+#endif /* Result_File_h */
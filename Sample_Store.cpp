@@ -0,0 +1,103 @@
+/**
+ * @file Sample_Store.cpp
+ * @brief Huge-page backed generation and sharing of standardized draws.
+ */
+
+#include "Sample_Store.h"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+
+#include "Invalid_Parameters.h"
+#include "Look_Back.h"
+#include "Numa_Topology.h"
+
+namespace
+{
+    constexpr std::size_t kHugePage = std::size_t(2) << 20;
+
+    /// Anonymous mapping of `bytes`, on explicit huge pages if any are reserved.
+    void* map_anonymous(std::size_t bytes, bool& huge)
+    {
+#ifdef MAP_HUGETLB
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            huge = true;
+            return p;
+        }
+#endif
+        void* q = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (q == MAP_FAILED)
+            throw std::runtime_error(std::string("Cannot map the sample store: ") + std::strerror(errno));
+#ifdef MADV_HUGEPAGE
+        huge = ::madvise(q, bytes, MADV_HUGEPAGE) == 0;
+#else
+        huge = false;
+#endif
+        return q;
+    }
+}
+
+std::uint64_t sample_store::offset(std::uint64_t chunk)
+{
+    return chunk * kMcChunkPaths;
+}
+
+sample_store::sample_store(std::uint64_t pairs)
+{
+    if (pairs == 0)
+        throw Invalid_Parameters("The sample store needs a positive number of pairs.");
+    const std::uint64_t n_chunks = chunk_count(pairs);
+    if (n_chunks > std::numeric_limits<std::size_t>::max() / (3 * sizeof(double) * kMcChunkPaths))
+        throw Invalid_Parameters("The sample store is too large for this address space.");
+
+    pairs_ = n_chunks * kMcChunkPaths;
+    seed_ = kMcSeed;
+    const std::size_t values = static_cast<std::size_t>(pairs_);
+    bytes_ = (3 * values * sizeof(double) + kHugePage - 1) / kHugePage * kHugePage;
+    base_ = map_anonymous(bytes_, huge_pages_);
+    Z_ = static_cast<double*>(base_);
+    U1_ = Z_ + values;
+    U2_ = U1_ + values;
+
+    // the draws simulate_chunk() would generate; pages are first touched by the node that
+    // will mostly read them
+    numa_parallel_for(static_cast<long>(n_chunks), [&](long c)
+    {
+        const std::uint64_t chunk = static_cast<std::uint64_t>(c);
+        draw_chunk(chunk, kMcChunkPaths, Z_ + offset(chunk), U1_ + offset(chunk), U2_ + offset(chunk));
+    });
+
+    ::mprotect(base_, bytes_, PROT_READ);
+}
+
+sample_store::~sample_store()
+{
+    if (base_)
+        ::munmap(base_, bytes_);
+}
+
+std::shared_ptr<const sample_store> sample_store::shared(std::uint64_t pairs)
+{
+    static std::mutex mutex;
+    static std::map<std::uint64_t, std::weak_ptr<const sample_store>> stores;
+
+    const std::uint64_t n_chunks = chunk_count(pairs);
+    std::lock_guard<std::mutex> lock(mutex);
+    std::weak_ptr<const sample_store>& slot = stores[n_chunks];
+    std::shared_ptr<const sample_store> store = slot.lock();
+    if (!store)
+    {
+        store = std::make_shared<const sample_store>(pairs);
+        slot = store;
+    }
+    return store;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file Sample_Store.h
+ * @brief Shared, read-only store of the standardized draws (Z, U1, U2) of the GBM engine.
+ *
+ * @details
+ * A GBM revaluation turns each path's standard normal Z and uniforms U1, U2 into a payoff
+ * with a few arithmetic operations, while drawing them costs most of the kernel time. A
+ * sample_store draws them once, for a seed and a number of antithetic pairs, in exactly the
+ * order simulate_chunk() would (chunk c from substream mc_substream_seed(c), clamped the
+ * same way). Pricing with a store attached is then a streaming transform over it, and
+ * returns the same bits as pricing without it.
+ *
+ * A store of P pairs serves any request for N <= P pairs: chunks are independent substreams,
+ * so the first N pairs of the store are the draws of an N-pair run. Requests above P, the
+ * moment-matched estimator (which draws half a block) and the Heston engine simulate as
+ * usual.
+ *
+ * Memory is 24 bytes per pair (P = 10^7 takes 240 MB). It is one anonymous mapping, backed
+ * by huge pages where the system allows it (explicit huge pages first, then transparent huge
+ * pages), filled by the NUMA-aware chunk scheduler and then made read-only.
+ * sample_store::shared() keeps one store per (seed, pairs) while any handle uses it.
+ *
+ * Exceptions:
+ * - Invalid arguments throw `Invalid_Parameters`; a failed mapping throws `std::runtime_error`.
+ */
+
+#ifndef Sample_Store_h
+#define Sample_Store_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class sample_store
+ * @brief Standardized draws of the first `pairs()` antithetic pairs of the default seed.
+ */
+class sample_store
+{
+public:
+    /** @brief Draws `pairs` pairs (rounded up to whole chunks). */
+    explicit sample_store(std::uint64_t pairs);
+    ~sample_store();
+
+    sample_store(const sample_store&) = delete;
+    sample_store& operator=(const sample_store&) = delete;
+
+    /** @brief Store shared by every caller asking for the same seed and size. */
+    static std::shared_ptr<const sample_store> shared(std::uint64_t pairs);
+
+    /** @brief Pairs held (a multiple of kMcChunkPaths). */
+    std::uint64_t pairs() const { return pairs_; }
+
+    /** @brief Seed the draws were generated from. */
+    std::uint64_t seed() const { return seed_; }
+
+    /** @brief True if the store holds every pair of a run of `N` pairs. */
+    bool covers(std::uint64_t N) const { return N <= pairs_; }
+
+    /** @brief True if the mapping is backed by huge pages (explicit or transparent). */
+    bool huge_pages() const { return huge_pages_; }
+
+    /** @brief First normal of chunk `chunk`; the chunk's values are contiguous. */
+    const double* Z(std::uint64_t chunk) const { return Z_ + offset(chunk); }
+    /** @brief First clamped uniform (running extremum of the + path) of chunk `chunk`. */
+    const double* U1(std::uint64_t chunk) const { return U1_ + offset(chunk); }
+    /** @brief First clamped uniform (running extremum of the - path) of chunk `chunk`. */
+    const double* U2(std::uint64_t chunk) const { return U2_ + offset(chunk); }
+
+private:
+    static std::uint64_t offset(std::uint64_t chunk);
+
+    std::uint64_t pairs_ = 0;
+    std::uint64_t seed_ = 0;
+    void* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    bool huge_pages_ = false;
+    double* Z_ = nullptr;
+    double* U1_ = nullptr;
+    double* U2_ = nullptr;
+};
+
+#endif /* Sample_Store_h */
@@ -0,0 +1,101 @@
+/**
+ * @file Tick_Revaluator.cpp
+ * @brief Path-set caching and prefix-sum revaluation of tick_revaluator.
+ */
+
+#include "Tick_Revaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Invalid_Parameters.h"
+#include "Numa_Topology.h"
+
+tick_revaluator::tick_revaluator(char option, double sigma, double interest_rate, double ttm, std::uint64_t N)
+    : option_(option), discount_(std::exp(-interest_rate * ttm)), pairs_(N), terminal_sum_(0.0)
+{
+    if (option != 'c' && option != 'p')
+        throw Invalid_Parameters("Option type can only be 'c' (Call) or 'p' (Put).");
+    if (!(sigma > 0) || !(ttm >= 0))
+        throw Invalid_Parameters("sigma must be positive and the maturity non-negative.");
+    if (N == 0)
+        throw Invalid_Parameters("N must be positive.");
+    if (N > std::numeric_limits<std::size_t>::max() / (4 * sizeof(double)))
+        throw Invalid_Parameters("N is too large for the tick cache.");
+
+    const double mu = (interest_rate - 0.5*sigma*sigma)*ttm;
+    const double vol = sigma * std::sqrt(ttm);
+    const double var2 = 2.0 * sigma*sigma * ttm;
+    // the running minimum (call) is below the midpoint, the running maximum (put) above it
+    const double side = (option == 'c') ? -0.5 : 0.5;
+
+    const std::uint64_t n_chunks = chunk_count(N);
+    extremum_.resize(static_cast<std::size_t>(2 * N));
+    std::vector<double> terminal(n_chunks);
+
+    // the draws of simulate_chunk(), relative to the spot
+    numa_parallel_for(static_cast<long>(n_chunks), [&](long c)
+    {
+        const std::uint64_t chunk = static_cast<std::uint64_t>(c);
+        const std::uint64_t first = chunk * kMcChunkPaths;
+        const unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(kMcChunkPaths, N - first));
+        std::vector<double> draws(3 * static_cast<std::size_t>(n));
+        double* Z = draws.data();
+        double* U1 = Z + n;
+        double* U2 = U1 + n;
+        draw_chunk(chunk, n, Z, U1, U2);
+
+        double* ext = extremum_.data() + 2 * first;
+        double sum = 0.0;
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            const double x_plus = mu - vol * Z[i];
+            const double x_minus = mu + vol * Z[i];
+            ext[2*i]     = std::exp(0.5*x_plus  + side*std::sqrt(std::max(0.0, x_plus*x_plus   - var2 * std::log(1.0 - U1[i]))));
+            ext[2*i + 1] = std::exp(0.5*x_minus + side*std::sqrt(std::max(0.0, x_minus*x_minus - var2 * std::log(1.0 - U2[i]))));
+            sum += std::exp(x_plus) + std::exp(x_minus);
+        }
+        terminal[c] = sum;
+    });
+
+    compensated_sum total;
+    for (const double t : terminal)
+        total.add(t);
+    terminal_sum_ = total.value();
+
+    std::sort(extremum_.begin(), extremum_.end());
+    prefix_.resize(extremum_.size() + 1);
+    compensated_sum running;
+    prefix_[0] = 0.0;
+    for (std::size_t i = 0; i < extremum_.size(); ++i)
+    {
+        running.add(extremum_[i]);
+        prefix_[i + 1] = running.value();
+    }
+}
+
+tick_quote tick_revaluator::quote(double S, double observed) const
+{
+    if (!(S > 0))
+        throw Invalid_Parameters("S must be positive.");
+
+    const double paths = 2.0 * static_cast<double>(pairs_);
+    const double scale = discount_ / paths;
+    const std::size_t n = extremum_.size();
+
+    if (option_ == 'c')
+    {
+        // paths whose minimum S m_i stays above the observed one are capped at it
+        const double level = observed > 0 ? observed / S : std::numeric_limits<double>::infinity();
+        const std::size_t k = static_cast<std::size_t>(std::lower_bound(extremum_.begin(), extremum_.end(), level) - extremum_.begin());
+        const double strikes = S * prefix_[k] + (observed > 0 ? observed * static_cast<double>(n - k) : 0.0);
+        return {scale * (S * terminal_sum_ - strikes), scale * (terminal_sum_ - prefix_[k])};
+    }
+
+    // put: paths whose maximum S M_i stays below the observed one are floored at it
+    const double level = observed > 0 ? observed / S : 0.0;
+    const std::size_t k = static_cast<std::size_t>(std::upper_bound(extremum_.begin(), extremum_.end(), level) - extremum_.begin());
+    const double strikes = S * (prefix_[n] - prefix_[k]) + observed * static_cast<double>(k);
+    return {scale * (strikes - S * terminal_sum_), scale * ((prefix_[n] - prefix_[k]) - terminal_sum_)};
+}
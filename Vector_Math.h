@@ -0,0 +1,246 @@
+/**
+ * @file Vector_Math.h
+ * @brief Branch-free exp, log, sqrt and normal quantile for the simulation loops, written so they vectorize.
+ *
+ * @details
+ * A loop calling the C library's exp or log stays scalar: the calls are opaque to the
+ * vectorizer, and sqrt may set errno unless the whole build uses -fno-math-errno. The
+ * functions below use only arithmetic, min/max and integer bit operations, so once
+ * inlined they vectorize at the width of the enclosing function's target (SSE2, AVX2 or
+ * AVX-512 in Look_Back_Kernel.cpp and Heston_Engine.cpp) and give the same result on
+ * every platform. Branch arms never hold arithmetic: with the default -ftrapping-math,
+ * GCC only if-converts such loops with AVX-512 masks.
+ *
+ * - exp: range reduction by ln 2 (Cody-Waite) and a Taylor polynomial.
+ * - log: fdlibm's reduction to [sqrt(2)/2, sqrt(2)) and its minimax polynomial in s^2.
+ * - sqrt: bit-level reciprocal square root estimate refined by Newton steps.
+ * - normal_quantile: Wichura's AS241 (PPND16); its three regions are all evaluated and one
+ *   is kept with select_sign(). Double precision only.
+ *
+ * Accuracy against the C library, measured on 2*10^7 random arguments per function:
+ * exp within 2 ulp, log and sqrt within 1 ulp, in both precisions. normal_quantile is within
+ * 7 ulp of the root of Phi(x) = p, measured on 4*10^6 arguments spread down to 2^-53 in
+ * both tails. Domains, which cover the arguments the kernels produce:
+ * - exp(x): x in [-708, 709.78] (float: [-86.5, 88.72]), where e^x is a normal number;
+ *   arguments outside are clamped to that interval.
+ * - log(x): positive normal x.
+ * - sqrt(x): zero or positive normal x; subnormal x gives a result of at most 2^-511
+ *   (float: 2^-63) but not the correctly rounded root.
+ * - normal_quantile(p): p in (0, 1), with 1 - p a normal number.
+ *
+ * NaN and infinite inputs are not handled.
+ */
+
+#ifndef Vector_Math_h
+#define Vector_Math_h
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define LB_VM_INLINE inline __attribute__((always_inline))
+#else
+  #define LB_VM_INLINE inline
+#endif
+
+namespace vm
+{
+    /** @brief `if_nonneg` when `s` is +0 or positive, `if_neg` when it is negative (sign bit set, -0 included). */
+    LB_VM_INLINE double select_sign(double s, double if_nonneg, double if_neg)
+    {
+        // a mask from the sign bit, with shift and subtract only: SSE2 has no 64-bit compare
+        // or arithmetic shift, and a ?: lets GCC move each operand's arithmetic into a branch
+        const std::uint64_t keep = (std::bit_cast<std::uint64_t>(s) >> 63) - 1;
+        return std::bit_cast<double>((std::bit_cast<std::uint64_t>(if_nonneg) & keep)
+                                   | (std::bit_cast<std::uint64_t>(if_neg) & ~keep));
+    }
+
+    /** @brief e^x in double precision. */
+    LB_VM_INLINE double exp(double x)
+    {
+        constexpr double log2e  = 1.4426950408889634074;
+        constexpr double ln2_hi = 6.93147180369123816490e-01;
+        constexpr double ln2_lo = 1.90821492927058770002e-10;
+        constexpr double shifter = 0x1.8p52; // adding it rounds to an integer held in the low mantissa bits
+
+        // bounds derived from x: with constant bounds GCC's PRE folds the clamped branch into
+        // its own path, and the loop no longer if-converts below AVX-512
+        const double zero = 0.0 * x;
+        const double xc = std::min(std::max(x, zero - 708.0), zero + 709.78);
+        const double t = xc * log2e + shifter;
+        const double n = t - shifter;
+        const double r = (xc - n * ln2_hi) - n * ln2_lo; // |r| <= ln(2)/2
+
+        double p = 1.0 / 6227020800.0; // 1/13!
+        p = p * r + 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        // 2^(n-1) built in the exponent field, so n = 1024 stays finite; the factor 2 restores it
+        const double half_scale = std::bit_cast<double>((std::bit_cast<std::uint64_t>(t) + 1022) << 52);
+        return 2.0 * (p * half_scale);
+    }
+
+    /** @brief Natural logarithm of a positive normal double. */
+    LB_VM_INLINE double log(double x)
+    {
+        constexpr double ln2_hi = 6.93147180369123816490e-01;
+        constexpr double ln2_lo = 1.90821492927058770002e-10;
+        constexpr double Lg1 = 6.666666666666735130e-01;
+        constexpr double Lg2 = 3.999999999940941908e-01;
+        constexpr double Lg3 = 2.857142874366239149e-01;
+        constexpr double Lg4 = 2.222219843214978396e-01;
+        constexpr double Lg5 = 1.818357216161805012e-01;
+        constexpr double Lg6 = 1.531383769920937332e-01;
+        constexpr double Lg7 = 1.479819860511658591e-01;
+
+        // x = 2^k (1 + f) with 1 + f in [sqrt(2)/2, sqrt(2))
+        const std::uint64_t ix = std::bit_cast<std::uint64_t>(x) + (0x3ff0000000000000ull - 0x3fe6a09e00000000ull);
+        const double k = std::bit_cast<double>((ix >> 52) | 0x4330000000000000ull) - (0x1p52 + 1023.0);
+        const double f = std::bit_cast<double>((ix & 0x000fffffffffffffull) + 0x3fe6a09e00000000ull) - 1.0;
+
+        const double hfsq = 0.5 * f * f;
+        const double s = f / (2.0 + f);
+        const double z = s * s;
+        const double w = z * z;
+        const double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+        const double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+        const double R = t2 + t1;
+        return s * (hfsq + R) + k * ln2_lo - hfsq + f + k * ln2_hi;
+    }
+
+    /** @brief Square root of a non-negative finite double. */
+    LB_VM_INLINE double sqrt(double x)
+    {
+        // estimate within 3.5% of 1/sqrt(x); each Newton step squares the relative error
+        double y = std::bit_cast<double>(0x5fe6eb50c7b537a9ull - (std::bit_cast<std::uint64_t>(x) >> 1));
+        const double hx = 0.5 * x;
+        y = y * (1.5 - hx * y * y);
+        y = y * (1.5 - hx * y * y);
+        y = y * (1.5 - hx * y * y);
+        y = y * (1.5 - hx * y * y);
+        const double s = x * y;
+        return s + (x - s * s) * (0.5 * y); // final correction on the root itself
+    }
+
+    /** @brief x with Phi(x) = p, Phi the standard normal distribution function. */
+    LB_VM_INLINE double normal_quantile(double p)
+    {
+        const double q = p - 0.5;
+
+        // central region, |q| <= 0.425
+        const double rc = 0.180625 - q * q;
+        const double central = q * (((((((2.5090809287301226727e+3 * rc + 3.3430575583588128105e+4) * rc
+                                         + 6.7265770927008700853e+4) * rc + 4.5921953931549871457e+4) * rc
+                                       + 1.3731693765509461125e+4) * rc + 1.9715909503065514427e+3) * rc
+                                     + 1.3314166789178437745e+2) * rc + 3.3871328727963666080e+0)
+                                 / (((((((5.2264952788528545610e+3 * rc + 2.8729085735721942674e+4) * rc
+                                         + 3.9307895800092710610e+4) * rc + 2.1213794301586595867e+4) * rc
+                                       + 5.3941960214247511077e+3) * rc + 6.8718700749205790830e+2) * rc
+                                     + 4.2313330701600911252e+1) * rc + 1.0);
+
+        // tails, in r = sqrt(-log(min(p, 1 - p))): r <= 5 and r > 5
+        const double r = vm::sqrt(-vm::log(std::min(p, 1.0 - p)));
+        const double rn = r - 1.6;
+        const double near = (((((((7.74545014278341407640e-4 * rn + 2.27238449892691845833e-2) * rn
+                                  + 2.41780725177450611770e-1) * rn + 1.27045825245236838258e+0) * rn
+                                + 3.64784832476320460504e+0) * rn + 5.76949722146069140550e+0) * rn
+                              + 4.63033784615654529590e+0) * rn + 1.42343711074968357734e+0)
+                          / (((((((1.05075007164441684324e-9 * rn + 5.47593808499534494600e-4) * rn
+                                  + 1.51986665636164571966e-2) * rn + 1.48103976427480074590e-1) * rn
+                                + 6.89767334985100004550e-1) * rn + 1.67638483018380384940e+0) * rn
+                              + 2.05319162663775882187e+0) * rn + 1.0);
+        const double rf = r - 5.0;
+        const double far = (((((((2.01033439929228813265e-7 * rf + 2.71155556874348757815e-5) * rf
+                                 + 1.24266094738807843860e-3) * rf + 2.65321895265761230930e-2) * rf
+                               + 2.96560571828504891230e-1) * rf + 1.78482653991729133580e+0) * rf
+                             + 5.46378491116411436990e+0) * rf + 6.65790464350110377720e+0)
+                         / (((((((2.04426310338993978564e-15 * rf + 1.42151175831644588870e-7) * rf
+                                 + 1.84631831751005468180e-5) * rf + 7.86869131145613259100e-4) * rf
+                               + 1.48753612908506148525e-2) * rf + 1.36929880922735805310e-1) * rf
+                             + 5.99832206555887937690e-1) * rf + 1.0);
+
+        // both tail values are positive; the lower tail takes the sign of q
+        const double tail_abs = select_sign(5.0 - r, near, far);
+        const double tail = std::bit_cast<double>(std::bit_cast<std::uint64_t>(tail_abs)
+                                                | (std::bit_cast<std::uint64_t>(q) & 0x8000000000000000ull));
+        return select_sign(0.425 - std::abs(q), central, tail);
+    }
+
+    /** @brief e^x in single precision. */
+    LB_VM_INLINE float exp(float x)
+    {
+        constexpr float log2e  = 1.44269504f;
+        constexpr float ln2_hi = 0.693145751953125f;
+        constexpr float ln2_lo = 1.428606765330187045e-06f;
+        constexpr float shifter = 0x1.8p23f;
+
+        const float zero = 0.0f * x;
+        const float xc = std::min(std::max(x, zero - 86.5f), zero + 88.72f);
+        const float t = xc * log2e + shifter;
+        const float n = t - shifter;
+        const float r = (xc - n * ln2_hi) - n * ln2_lo;
+
+        float p = 1.0f / 5040.0f;
+        p = p * r + 1.0f / 720.0f;
+        p = p * r + 1.0f / 120.0f;
+        p = p * r + 1.0f / 24.0f;
+        p = p * r + 1.0f / 6.0f;
+        p = p * r + 0.5f;
+        p = p * r + 1.0f;
+        p = p * r + 1.0f;
+
+        const float half_scale = std::bit_cast<float>((std::bit_cast<std::uint32_t>(t) + 126u) << 23);
+        return 2.0f * (p * half_scale);
+    }
+
+    /** @brief Natural logarithm of a positive normal float. */
+    LB_VM_INLINE float log(float x)
+    {
+        constexpr float ln2_hi = 6.9313812256e-01f;
+        constexpr float ln2_lo = 9.0580006145e-06f;
+        constexpr float Lg1 = 0xaaaaaa.0p-24f;
+        constexpr float Lg2 = 0xccce13.0p-25f;
+        constexpr float Lg3 = 0x91e9ee.0p-25f;
+        constexpr float Lg4 = 0xf89e26.0p-26f;
+
+        const std::uint32_t ix = std::bit_cast<std::uint32_t>(x) + (0x3f800000u - 0x3f3504f3u);
+        const float k = static_cast<float>(static_cast<std::int32_t>(ix >> 23) - 0x7f);
+        const float f = std::bit_cast<float>((ix & 0x007fffffu) + 0x3f3504f3u) - 1.0f;
+
+        const float hfsq = 0.5f * f * f;
+        const float s = f / (2.0f + f);
+        const float z = s * s;
+        const float w = z * z;
+        const float t1 = w * (Lg2 + w * Lg4);
+        const float t2 = z * (Lg1 + w * Lg3);
+        const float R = t2 + t1;
+        return s * (hfsq + R) + k * ln2_lo - hfsq + f + k * ln2_hi;
+    }
+
+    /** @brief Square root of a non-negative finite float. */
+    LB_VM_INLINE float sqrt(float x)
+    {
+        float y = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<std::uint32_t>(x) >> 1));
+        const float hx = 0.5f * x;
+        y = y * (1.5f - hx * y * y);
+        y = y * (1.5f - hx * y * y);
+        y = y * (1.5f - hx * y * y);
+        const float s = x * y;
+        return s + (x - s * s) * (0.5f * y);
+    }
+}
+
+#endif /* Vector_Math_h */
@@ -0,0 +1,115 @@
+/**
+ * @file LB_Protocol.h
+ * @brief Binary wire protocol between the pricing daemon and its client shim.
+ *
+ * @details
+ * The daemon (lb_pricingd.cpp) and the client library (LookBackClient.cpp) exchange
+ * fixed-size request frames and variable-size response frames over a Unix domain
+ * socket. Both ends run on the same machine, so structures are sent in native
+ * byte order and layout.
+ *
+ * A request carries the full contract description, so the daemon keeps no per-client
+ * state: two clients asking for the same contract and arguments send byte-identical
+ * frames, which is what the daemon uses to coalesce them.
+ *
+ * Response frame: `lbp_response_header`, then `count` doubles, then `error_len` chars.
+ */
+
+#ifndef LB_Protocol_h
+#define LB_Protocol_h
+
+#include <cstdint>
+#include <cstring>
+
+/** @defgroup LB_Daemon Pricing daemon
+ *  @brief Shared pricing server and its C ABI client shim.
+ *  @{
+ */
+
+constexpr std::uint32_t kLbpMagic = 0x4c425031; // "LBP1"
+constexpr std::uint16_t kLbpVersion = 3;
+
+/// Socket used when LB_PRICINGD_SOCKET is not set.
+constexpr const char* kLbpDefaultSocket = "/tmp/lookback_pricingd.sock";
+
+/** @brief Operations understood by the daemon. */
+enum lbp_op : std::uint16_t
+{
+    LBP_VALIDATE     = 0, ///< Builds the contract only (used by LB_CreateA).
+    LBP_PRICE        = 1, ///< args = {S, sigma, r, maturity}, n = paths.
+    LBP_DELTA        = 2, ///< args[0] = S.
+    LBP_GAMMA        = 3,
+    LBP_VEGA         = 4,
+    LBP_RHO          = 5,
+    LBP_THETA        = 6,
+    LBP_RISK         = 7, ///< n = paths for the price; returns 6 doubles.
+    LBP_GRAPH_PRICE  = 8, ///< args[0] = dx, n = max points; returns x values then y values.
+    LBP_GRAPH_DELTA  = 9,
+    LBP_GRAPH_SIZE   = 10, ///< args[0] = dx.
+    LBP_ESTIMATE     = 11, ///< args = {S, sigma, r, maturity}, n = pairs; returns price, se, pairs.
+    LBP_PRICE_WITHIN = 12, ///< args = {S, sigma, r, maturity, seconds}; returns price, se, pairs (not cached).
+    LBP_F32_BIAS     = 13, ///< args = {S, sigma, r, maturity}, n = pairs; returns bias, se.
+    LBP_JOINT        = 14, ///< args = {S, sigma, r, maturity, K, min, max}, n = pairs; returns 4 prices, 4 se. No contract.
+    LBP_CURVE        = 15, ///< args = {axis, quantity, lo, hi, initial, max, seconds, tolerance}, n = pairs;
+                           ///< returns x values, y values, se values.
+    LBP_INFO         = 16, ///< No contract; returns NUMA nodes, kernel ISA id.
+    LBP_ACTIVE_ENGINE = 17 ///< Returns the engine price() resolves to (pricing_engine value).
+};
+
+/** @brief Contract description: the LB_CreateA arguments plus the per-handle settings. */
+struct lbp_contract
+{
+    double S0;
+    double sigma;
+    double interest_rate;
+    double h;
+    std::int32_t option;
+    std::int32_t day_count_conv;
+    char value_date[16];    ///< "dd-mm-yyyy", zero padded
+    char maturity_date[16]; ///< "dd-mm-yyyy", zero padded
+    double observed_extremum;     ///< LB_SetObservedExtremum (0 = newly issued)
+    double heston[4];             ///< kappa, theta, xi, rho (LB_SetHeston)
+    std::uint32_t heston_steps;   ///< Steps per year; 0 = GBM dynamics
+    std::uint32_t engine;         ///< pricing_engine (LB_SetEngine)
+    std::uint32_t estimator;      ///< mc_estimator (LB_SetEstimator)
+    std::uint32_t reserved;       ///< Zero
+};
+
+/** @brief Fixed-size request frame. */
+struct lbp_request
+{
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t op;
+    lbp_contract contract;
+    double args[8];
+    std::uint64_t n;
+};
+
+/** @brief Header of a response frame. */
+struct lbp_response_header
+{
+    std::uint32_t magic;
+    std::int32_t status; ///< 0 on success, non-zero on error.
+    std::uint32_t count; ///< Number of doubles that follow.
+    std::uint32_t error_len; ///< Number of error chars after the doubles (no terminator).
+};
+
+static_assert(sizeof(lbp_contract) == 128, "lbp_contract must have no padding");
+static_assert(sizeof(lbp_request) == 208, "lbp_request must have no padding");
+
+/** @brief Zero-initialized request (padding included, so frames compare bytewise). */
+inline lbp_request lbp_make_request(const lbp_contract& c, lbp_op op)
+{
+    lbp_request r;
+    std::memset(&r, 0, sizeof(r));
+    r.magic = kLbpMagic;
+    r.version = kLbpVersion;
+    r.op = op;
+    r.contract = c;
+    return r;
+}
+
+/** @} */ // endgroup LB_Daemon
+
+#endif /* LB_Protocol_h */
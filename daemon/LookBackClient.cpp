@@ -0,0 +1,712 @@
+/**
+ * @file LookBackClient.cpp
+ * @brief Thin client shim exposing the LookBackDll.h ABI on top of lb_pricingd.
+ *
+ * @details
+ * Build this file (with Date_Dealing.cpp, for LB_GetYearFraction) into a library
+ * named like the regular one, and existing callers (Excel/VBA, scripts) transparently
+ * share the daemon's warm engine and caches instead of loading their own.
+ *
+ * - Handles store the contract description client side; every call sends it along,
+ *   so the daemon stays stateless.
+ * - Each calling thread keeps its own connection, opened lazily and reopened once
+ *   if the daemon restarted.
+ * - The socket path is read from LB_PRICINGD_SOCKET (default kLbpDefaultSocket).
+ * - Error semantics match LookBackDll.cpp: failures return 0 and set the thread-local
+ *   last error.
+ *
+ * Every LB_* function of LookBackDll.h is exported (the Windows-only wide-character
+ * variants aside). Settings kept with the contract (LB_SetEngine, LB_SetEstimator,
+ * LB_SetHeston, LB_SetBlackScholes, LB_SetObservedExtremum) are sent with each
+ * request; LB_ENGINE_SURFACE is rejected since surfaces cannot be attached remotely.
+ * These need state in the calling process and only set the last error:
+ * LB_SetThreadBudget, LB_GetThreadBudget, LB_AttachSurface, LB_UseSampleStore, LB_PrepareTicks,
+ * LB_PriceTick, LB_PriceProgressive, LB_PriceCheckpointed, LB_PriceSharedPaths,
+ * LB_WriteRiskReports. LB_GraphicPriceStream and LB_GraphicDeltaStream receive the graph in
+ * one reply, so their callback fires only once the whole graph has arrived.
+ *
+ * Build example:
+ * @code
+ * clang++ -std=c++20 -O2 -fPIC -dynamiclib -I. daemon/LookBackClient.cpp Date_Dealing.cpp \
+ *   -Wl,-install_name,@rpath/libLookBack.dylib -o libLookBack.dylib
+ * @endcode
+ */
+
+#include "LookBackDll.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Date_Dealing.h"
+#include "LB_Protocol.h"
+
+namespace
+{
+    thread_local std::string g_lastErrorA;
+
+    /** @brief Connection of the calling thread to the daemon, closed when the thread exits. */
+    struct daemon_connection
+    {
+        int fd = -1;
+
+        daemon_connection() = default;
+        daemon_connection(const daemon_connection&) = delete;
+        daemon_connection& operator=(const daemon_connection&) = delete;
+        ~daemon_connection()
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+    };
+
+    thread_local daemon_connection g_conn;
+
+    /** @brief Client-side record behind an LB_Handle. */
+    struct client_contract
+    {
+        lbp_contract c;
+    };
+
+    struct reply
+    {
+        bool ok = false;
+        std::vector<double> values;
+    };
+
+    void set_error_a(const std::string& s) { g_lastErrorA = s; }
+    void clear_error() { g_lastErrorA.clear(); }
+
+    /** @brief Error of an LB_* function that needs process-local state the daemon does not keep. */
+    void unsupported(const char* where)
+    {
+        clear_error();
+        set_error_a(std::string(where) + " is not supported through lb_pricingd; link the full library instead");
+    }
+
+    client_contract* as_ptr(LB_Handle h) { return static_cast<client_contract*>(h); }
+
+    bool read_all(int fd, void* buf, std::size_t len)
+    {
+        char* p = static_cast<char*>(buf);
+        while (len > 0)
+        {
+            const ssize_t k = ::read(fd, p, len);
+            if (k <= 0)
+                return false;
+            p += k;
+            len -= static_cast<std::size_t>(k);
+        }
+        return true;
+    }
+
+    // a write to a daemon that went away must fail with EPIPE, not raise SIGPIPE in the host
+#ifdef MSG_NOSIGNAL
+    constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int kSendFlags = 0; // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+    bool write_all(int fd, const void* buf, std::size_t len)
+    {
+        const char* p = static_cast<const char*>(buf);
+        while (len > 0)
+        {
+            const ssize_t k = ::send(fd, p, len, kSendFlags);
+            if (k <= 0)
+                return false;
+            p += k;
+            len -= static_cast<std::size_t>(k);
+        }
+        return true;
+    }
+
+    bool connect_daemon()
+    {
+        if (g_conn.fd >= 0)
+            return true;
+
+        const char* env = std::getenv("LB_PRICINGD_SOCKET");
+        const std::string path = env ? env : kLbpDefaultSocket;
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            return false;
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+#ifdef SO_NOSIGPIPE
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        g_conn.fd = fd;
+        return true;
+    }
+
+    void disconnect()
+    {
+        if (g_conn.fd >= 0)
+            ::close(g_conn.fd);
+        g_conn.fd = -1;
+    }
+
+    bool exchange(const lbp_request& req, lbp_response_header& hdr, std::vector<double>& values, std::string& error)
+    {
+        if (!connect_daemon() || !write_all(g_conn.fd, &req, sizeof(req)) || !read_all(g_conn.fd, &hdr, sizeof(hdr)) || hdr.magic != kLbpMagic)
+            return false;
+
+        values.resize(hdr.count);
+        error.resize(hdr.error_len);
+        return read_all(g_conn.fd, values.data(), values.size() * sizeof(double))
+            && read_all(g_conn.fd, error.data(), error.size());
+    }
+
+    /** @brief Sends one request; on failure sets the last error prefixed with `where`. */
+    reply call(const char* where, const lbp_request& req)
+    {
+        reply out;
+        lbp_response_header hdr{};
+        std::string error;
+
+        bool sent = exchange(req, hdr, out.values, error);
+        if (!sent)
+        {
+            // stale connection (daemon restarted): reconnect once
+            disconnect();
+            sent = exchange(req, hdr, out.values, error);
+        }
+
+        if (!sent)
+        {
+            disconnect();
+            set_error_a(std::string(where) + ": cannot reach lb_pricingd");
+        }
+        else if (hdr.status != 0)
+            set_error_a(std::string(where) + ": " + error);
+        else
+            out.ok = true;
+        return out;
+    }
+
+    double call_scalar(const char* where, LB_Handle h, lbp_op op, double a0 = 0.0)
+    {
+        clear_error();
+        if (!h) { set_error_a(std::string("Null handle in ") + where); return 0.0; }
+
+        lbp_request req = lbp_make_request(as_ptr(h)->c, op);
+        req.args[0] = a0;
+        const reply r = call(where, req);
+        return (r.ok && !r.values.empty()) ? r.values[0] : 0.0;
+    }
+
+    int call_graph(const char* where, LB_Handle h, lbp_op op, double dx, double* x_out, double* y_out, int max_len,
+                   LB_PointCallback cb, void* user)
+    {
+        clear_error();
+        if (!h) { set_error_a(std::string("Null handle in ") + where); return 0; }
+
+        if (!x_out || !y_out || max_len <= 0)
+        {
+            lbp_request req = lbp_make_request(as_ptr(h)->c, LBP_GRAPH_SIZE);
+            req.args[0] = dx;
+            const reply r = call(where, req);
+            if (!r.ok || r.values.empty())
+                return 0;
+            if (!(r.values[0] <= static_cast<double>(std::numeric_limits<int>::max())))
+            {
+                set_error_a(std::string("dx is too small: the graph would exceed INT_MAX points in ") + where);
+                return 0;
+            }
+            return static_cast<int>(r.values[0]);
+        }
+
+        lbp_request req = lbp_make_request(as_ptr(h)->c, op);
+        req.args[0] = dx;
+        req.n = static_cast<std::uint64_t>(max_len);
+        const reply r = call(where, req);
+        if (!r.ok)
+            return 0;
+
+        // x then y for each point, never more points than requested
+        if (r.values.size() % 2 != 0 || r.values.size() / 2 > static_cast<std::size_t>(max_len))
+        {
+            set_error_a(std::string(where) + ": malformed reply from lb_pricingd");
+            return 0;
+        }
+        const int k = static_cast<int>(r.values.size() / 2);
+        for (int i = 0; i < k; ++i)
+        {
+            x_out[i] = r.values[static_cast<std::size_t>(i)];
+            y_out[i] = r.values[static_cast<std::size_t>(k + i)];
+            if (cb)
+                cb(user, i, x_out[i], y_out[i]);
+        }
+        return k;
+    }
+
+    /** @brief Applies `change` to the contract of `h` if the daemon accepts the result. */
+    template <class F>
+    int update_contract(const char* where, LB_Handle h, F&& change)
+    {
+        clear_error();
+        if (!h) { set_error_a(std::string("Null handle in ") + where); return 0; }
+
+        lbp_contract c = as_ptr(h)->c;
+        change(c);
+        if (!call(where, lbp_make_request(c, LBP_VALIDATE)).ok)
+            return 0;
+        as_ptr(h)->c = c;
+        return 1;
+    }
+
+    /** @brief Sends an estimate-type request; returns the price and fills the optional outputs. */
+    double call_estimate(const char* where, LB_Handle h, lbp_request& req, double* se_out, unsigned long long* paths_out)
+    {
+        clear_error();
+        if (!h) { set_error_a(std::string("Null handle in ") + where); return 0.0; }
+
+        req.contract = as_ptr(h)->c;
+        const reply r = call(where, req);
+        if (!r.ok || r.values.size() != 3)
+            return 0.0;
+        if (se_out) *se_out = r.values[1];
+        if (paths_out) *paths_out = static_cast<unsigned long long>(r.values[2]);
+        return r.values[0];
+    }
+
+    /** @brief Daemon-wide information: {NUMA nodes, kernel ISA id}, empty on error. */
+    std::vector<double> daemon_info(const char* where)
+    {
+        clear_error();
+        return call(where, lbp_make_request(lbp_contract{}, LBP_INFO)).values;
+    }
+
+    void copy_date(char (&dst)[16], const char* src)
+    {
+        std::memset(dst, 0, sizeof(dst));
+        std::strncpy(dst, src, sizeof(dst) - 1);
+    }
+
+    DayCountConv map_ddc(int ddc)
+    {
+        switch (ddc)
+        {
+            case LB_ACT_360:       return DayCountConv::ACT_360;
+            case LB_ACT_365F:      return DayCountConv::ACT_365F;
+            case LB_THIRTY_360_US: return DayCountConv::THIRTY_360_US;
+            case LB_THIRTY_360_EU: return DayCountConv::THIRTY_360_EU;
+            case LB_ACT_ACT_ISDA:  return DayCountConv::ACT_ACT_ISDA;
+            default:               return DayCountConv::ACT_365F;
+        }
+    }
+}
+
+LB_API LB_Handle LB_CALL LB_CreateA(double S0, const char* value_date_dd_mm_yyyy, const char* maturity_date_dd_mm_yyyy,
+                                    double sigma, double interest_rate, int option_ascii, double h, int day_count_conv)
+{
+    clear_error();
+    if (!value_date_dd_mm_yyyy || !maturity_date_dd_mm_yyyy)
+    {
+        set_error_a("Null date string in LB_CreateA");
+        return nullptr;
+    }
+
+    lbp_contract c;
+    std::memset(&c, 0, sizeof(c));
+    c.S0 = S0;
+    c.sigma = sigma;
+    c.interest_rate = interest_rate;
+    c.h = h;
+    c.option = option_ascii;
+    c.day_count_conv = day_count_conv;
+    copy_date(c.value_date, value_date_dd_mm_yyyy);
+    copy_date(c.maturity_date, maturity_date_dd_mm_yyyy);
+
+    // the daemon builds the contract once, so invalid inputs fail here as with the local library
+    if (!call("LB_CreateA", lbp_make_request(c, LBP_VALIDATE)).ok)
+        return nullptr;
+
+    return new client_contract{c};
+}
+
+LB_API void LB_CALL LB_Destroy(LB_Handle h)
+{
+    clear_error();
+    delete as_ptr(h);
+}
+
+LB_API int LB_CALL LB_CreateBulkA(int n, const double* S0, const char* const* value_dates_dd_mm_yyyy,
+                                  const char* const* maturity_dates_dd_mm_yyyy, const double* sigma,
+                                  const double* interest_rate, const int* option_ascii, const double* h,
+                                  const int* day_count_conv, LB_Handle* out)
+{
+    clear_error();
+    if (n <= 0) return 0;
+    if (!S0 || !value_dates_dd_mm_yyyy || !maturity_dates_dd_mm_yyyy || !sigma || !interest_rate
+        || !option_ascii || !h || !day_count_conv || !out)
+    {
+        set_error_a("Null array in LB_CreateBulkA");
+        return 0;
+    }
+
+    int created = 0;
+    std::string first_error;
+    for (int i = 0; i < n; ++i)
+    {
+        out[i] = LB_CreateA(S0[i], value_dates_dd_mm_yyyy[i], maturity_dates_dd_mm_yyyy[i], sigma[i],
+                            interest_rate[i], option_ascii[i], h[i], day_count_conv[i]);
+        if (out[i])
+            ++created;
+        else if (first_error.empty())
+            first_error = "LB_CreateBulkA[" + std::to_string(i) + "]: " + g_lastErrorA;
+    }
+    g_lastErrorA = first_error;
+    return created;
+}
+
+LB_API int LB_CALL LB_DestroyBulk(const LB_Handle* handles, int n)
+{
+    clear_error();
+    if (!handles || n <= 0) return 0;
+
+    int destroyed = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (handles[i])
+        {
+            delete as_ptr(handles[i]);
+            ++destroyed;
+        }
+    }
+    return destroyed;
+}
+
+LB_API int LB_CALL LB_IsValidHandle(LB_Handle h)
+{
+    // client handles are plain records: only null can be detected
+    return h ? 1 : 0;
+}
+
+LB_API int LB_CALL LB_SetThreadBudget(int) { unsupported("LB_SetThreadBudget"); return 0; }
+LB_API int LB_CALL LB_GetThreadBudget(void) { unsupported("LB_GetThreadBudget"); return 0; }
+
+LB_API int LB_CALL LB_SetEngine(LB_Handle h, int engine)
+{
+    if (engine < LB_ENGINE_AUTO || engine > LB_ENGINE_SURFACE) { clear_error(); set_error_a("Unknown engine in LB_SetEngine"); return 0; }
+    return update_contract("LB_SetEngine", h, [&](lbp_contract& c) { c.engine = static_cast<std::uint32_t>(engine); });
+}
+
+LB_API int LB_CALL LB_SetEstimator(LB_Handle h, int estimator)
+{
+    if (estimator < LB_ESTIMATOR_ANTITHETIC || estimator > LB_ESTIMATOR_MOMENT_MATCHED) { clear_error(); set_error_a("Unknown estimator in LB_SetEstimator"); return 0; }
+    return update_contract("LB_SetEstimator", h, [&](lbp_contract& c) { c.estimator = static_cast<std::uint32_t>(estimator); });
+}
+
+LB_API int LB_CALL LB_GetActiveEngine(LB_Handle h)
+{
+    clear_error();
+    if (!h) { set_error_a("Null handle in LB_GetActiveEngine"); return -1; }
+
+    const reply r = call("LB_GetActiveEngine", lbp_make_request(as_ptr(h)->c, LBP_ACTIVE_ENGINE));
+    if (!r.ok || r.values.size() != 1)
+        return -1;
+    return static_cast<int>(r.values[0]);
+}
+
+LB_API int LB_CALL LB_SetHeston(LB_Handle h, double kappa, double theta, double xi, double rho, unsigned int steps_per_year)
+{
+    if (steps_per_year == 0) { clear_error(); set_error_a("LB_SetHeston: Heston steps_per_year must be positive."); return 0; }
+    return update_contract("LB_SetHeston", h, [&](lbp_contract& c)
+    {
+        c.heston[0] = kappa;
+        c.heston[1] = theta;
+        c.heston[2] = xi;
+        c.heston[3] = rho;
+        c.heston_steps = steps_per_year;
+    });
+}
+
+LB_API int LB_CALL LB_SetBlackScholes(LB_Handle h)
+{
+    return update_contract("LB_SetBlackScholes", h, [](lbp_contract& c)
+    {
+        std::memset(c.heston, 0, sizeof(c.heston));
+        c.heston_steps = 0;
+    });
+}
+
+LB_API int LB_CALL LB_SetObservedExtremum(LB_Handle h, double extremum)
+{
+    return update_contract("LB_SetObservedExtremum", h, [&](lbp_contract& c) { c.observed_extremum = extremum; });
+}
+
+LB_API int LB_CALL LB_AttachSurface(LB_Handle, const char*) { unsupported("LB_AttachSurface"); return 0; }
+LB_API int LB_CALL LB_UseSampleStore(LB_Handle, unsigned long long) { unsupported("LB_UseSampleStore"); return 0; }
+LB_API int LB_CALL LB_PrepareTicks(LB_Handle, unsigned long long) { unsupported("LB_PrepareTicks"); return 0; }
+LB_API double LB_CALL LB_PriceTick(LB_Handle, double, double*) { unsupported("LB_PriceTick"); return 0.0; }
+
+LB_API double LB_CALL LB_EstimateF32Bias(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                         unsigned long long N, double* se_out)
+{
+    lbp_request req = lbp_make_request(lbp_contract{}, LBP_F32_BIAS);
+    req.args[0] = S;
+    req.args[1] = sigma;
+    req.args[2] = interest_rate;
+    req.args[3] = maturity;
+    req.n = N;
+    return call_estimate("LB_EstimateF32Bias", h, req, se_out, nullptr);
+}
+
+LB_API double LB_CALL LB_Price(LB_Handle h, double S, double sigma, double interest_rate, double maturity, unsigned int N)
+{
+    clear_error();
+    if (!h) { set_error_a("Null handle in LB_Price"); return 0.0; }
+
+    lbp_request req = lbp_make_request(as_ptr(h)->c, LBP_PRICE);
+    req.args[0] = S;
+    req.args[1] = sigma;
+    req.args[2] = interest_rate;
+    req.args[3] = maturity;
+    req.n = N;
+    const reply r = call("LB_Price", req);
+    return (r.ok && !r.values.empty()) ? r.values[0] : 0.0;
+}
+
+LB_API double LB_CALL LB_PriceLarge(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                    unsigned long long N, double* se_out)
+{
+    lbp_request req = lbp_make_request(lbp_contract{}, LBP_ESTIMATE);
+    req.args[0] = S;
+    req.args[1] = sigma;
+    req.args[2] = interest_rate;
+    req.args[3] = maturity;
+    req.n = N;
+    return call_estimate("LB_PriceLarge", h, req, se_out, nullptr);
+}
+
+LB_API double LB_CALL LB_PriceWithin(LB_Handle h, double S, double sigma, double interest_rate, double maturity,
+                                     double budget_ms, double* se_out, unsigned long long* paths_out)
+{
+    lbp_request req = lbp_make_request(lbp_contract{}, LBP_PRICE_WITHIN);
+    req.args[0] = S;
+    req.args[1] = sigma;
+    req.args[2] = interest_rate;
+    req.args[3] = maturity;
+    req.args[4] = budget_ms / 1000.0;
+    return call_estimate("LB_PriceWithin", h, req, se_out, paths_out);
+}
+
+LB_API double LB_CALL LB_PriceProgressive(LB_Handle, double, double, double, double, unsigned long long, unsigned long long,
+                                          LB_ProgressCallback, void*, double*, unsigned long long*)
+{
+    unsupported("LB_PriceProgressive");
+    return 0.0;
+}
+
+LB_API double LB_CALL LB_PriceCheckpointed(LB_Handle, double, double, double, double, unsigned long long, const char*,
+                                           unsigned long long, double*)
+{
+    unsupported("LB_PriceCheckpointed");
+    return 0.0;
+}
+
+LB_API int LB_CALL LB_PriceSharedPaths(const LB_Handle*, int, unsigned long long, double*, double*)
+{
+    unsupported("LB_PriceSharedPaths");
+    return 0;
+}
+
+LB_API int LB_CALL LB_PriceJoint(double S, double sigma, double interest_rate, double maturity, unsigned long long N,
+                                 double range_strike, double observed_min, double observed_max,
+                                 double* prices_out, double* se_out)
+{
+    clear_error();
+    if (!prices_out) { set_error_a("Null output in LB_PriceJoint"); return 0; }
+
+    lbp_request req = lbp_make_request(lbp_contract{}, LBP_JOINT);
+    req.args[0] = S;
+    req.args[1] = sigma;
+    req.args[2] = interest_rate;
+    req.args[3] = maturity;
+    req.args[4] = range_strike;
+    req.args[5] = observed_min;
+    req.args[6] = observed_max;
+    req.n = N;
+    const reply r = call("LB_PriceJoint", req);
+    if (!r.ok || r.values.size() != 2 * LB_JOINT_COUNT)
+        return 0;
+    for (int q = 0; q < LB_JOINT_COUNT; ++q)
+    {
+        prices_out[q] = r.values[static_cast<std::size_t>(q)];
+        if (se_out) se_out[q] = r.values[static_cast<std::size_t>(LB_JOINT_COUNT + q)];
+    }
+    return 1;
+}
+
+LB_API double LB_CALL LB_Delta(LB_Handle h, double S) { return call_scalar("LB_Delta", h, LBP_DELTA, S); }
+LB_API double LB_CALL LB_Theta(LB_Handle h) { return call_scalar("LB_Theta", h, LBP_THETA); }
+LB_API double LB_CALL LB_Rho(LB_Handle h)   { return call_scalar("LB_Rho", h, LBP_RHO); }
+LB_API double LB_CALL LB_Vega(LB_Handle h)  { return call_scalar("LB_Vega", h, LBP_VEGA); }
+LB_API double LB_CALL LB_Gamma(LB_Handle h) { return call_scalar("LB_Gamma", h, LBP_GAMMA); }
+
+LB_API int LB_CALL LB_RiskReport(LB_Handle h, unsigned long long N, LB_Risk* out)
+{
+    clear_error();
+    if (!h) { set_error_a("Null handle in LB_RiskReport"); return 0; }
+    if (!out) { set_error_a("Null output in LB_RiskReport"); return 0; }
+
+    lbp_request req = lbp_make_request(as_ptr(h)->c, LBP_RISK);
+    req.n = N;
+    const reply r = call("LB_RiskReport", req);
+    if (!r.ok || r.values.size() != 6)
+        return 0;
+
+    out->price = r.values[0];
+    out->delta = r.values[1];
+    out->gamma = r.values[2];
+    out->vega  = r.values[3];
+    out->rho   = r.values[4];
+    out->theta = r.values[5];
+    return 1;
+}
+
+LB_API int LB_CALL LB_GraphicPrice(LB_Handle h, double dx, double* x_out, double* y_out, int max_len)
+{
+    return call_graph("LB_GraphicPrice", h, LBP_GRAPH_PRICE, dx, x_out, y_out, max_len, nullptr, nullptr);
+}
+
+LB_API int LB_CALL LB_GraphicDelta(LB_Handle h, double dx, double* x_out, double* y_out, int max_len)
+{
+    return call_graph("LB_GraphicDelta", h, LBP_GRAPH_DELTA, dx, x_out, y_out, max_len, nullptr, nullptr);
+}
+
+LB_API int LB_CALL LB_GraphicPriceStream(LB_Handle h, double dx, double* x_out, double* y_out, int max_len, LB_PointCallback cb, void* user)
+{
+    if (!x_out || !y_out || max_len <= 0) { clear_error(); set_error_a("Null or empty buffers in LB_GraphicPriceStream"); return 0; }
+    return call_graph("LB_GraphicPriceStream", h, LBP_GRAPH_PRICE, dx, x_out, y_out, max_len, cb, user);
+}
+
+LB_API int LB_CALL LB_GraphicDeltaStream(LB_Handle h, double dx, double* x_out, double* y_out, int max_len, LB_PointCallback cb, void* user)
+{
+    if (!x_out || !y_out || max_len <= 0) { clear_error(); set_error_a("Null or empty buffers in LB_GraphicDeltaStream"); return 0; }
+    return call_graph("LB_GraphicDeltaStream", h, LBP_GRAPH_DELTA, dx, x_out, y_out, max_len, cb, user);
+}
+
+LB_API int LB_CALL LB_WriteRiskReports(const LB_Handle*, const unsigned long long*, int, unsigned long long, const char*)
+{
+    unsupported("LB_WriteRiskReports");
+    return 0;
+}
+
+LB_API int LB_CALL LB_SampleCurve(LB_Handle h, int axis, int quantity, double lo, double hi,
+                                  int initial_points, int max_points, double budget_ms, unsigned long long N,
+                                  double tolerance, double* x_out, double* y_out, double* se_out, int max_len)
+{
+    clear_error();
+    if (!h) { set_error_a("Null handle in LB_SampleCurve"); return 0; }
+    if (initial_points < 3 || max_points < initial_points) { set_error_a("Invalid point budget in LB_SampleCurve"); return 0; }
+    if (!x_out || !y_out || max_len <= 0)
+        return max_points;
+    if (std::min(max_points, max_len) < initial_points) { set_error_a("Buffers too small for the initial grid in LB_SampleCurve"); return 0; }
+
+    lbp_request req = lbp_make_request(as_ptr(h)->c, LBP_CURVE);
+    req.args[0] = axis;
+    req.args[1] = quantity;
+    req.args[2] = lo;
+    req.args[3] = hi;
+    req.args[4] = initial_points;
+    req.args[5] = std::min(max_points, max_len);
+    req.args[6] = budget_ms / 1000.0;
+    req.args[7] = tolerance;
+    req.n = N;
+    const reply r = call("LB_SampleCurve", req);
+    if (!r.ok)
+        return 0;
+
+    // x, y and se for each point, never more points than requested
+    if (r.values.size() % 3 != 0 || r.values.size() / 3 > static_cast<std::size_t>(std::min(max_points, max_len)))
+    {
+        set_error_a("LB_SampleCurve: malformed reply from lb_pricingd");
+        return 0;
+    }
+    const std::size_t k = r.values.size() / 3;
+    for (std::size_t i = 0; i < k; ++i)
+    {
+        x_out[i] = r.values[i];
+        y_out[i] = r.values[k + i];
+        if (se_out) se_out[i] = r.values[2 * k + i];
+    }
+    return static_cast<int>(k);
+}
+
+LB_API int LB_CALL LB_GetNumaNodes()
+{
+    const std::vector<double> info = daemon_info("LB_GetNumaNodes");
+    return info.size() == 2 ? static_cast<int>(info[0]) : 0;
+}
+
+LB_API int LB_CALL LB_GetKernelIsa()
+{
+    const std::vector<double> info = daemon_info("LB_GetKernelIsa");
+    return info.size() == 2 ? static_cast<int>(info[1]) : -1;
+}
+
+LB_API int LB_CALL LB_GetKernelIsaNameA(char* buffer, int buffer_len)
+{
+    static const char* const names[] = {"baseline", "avx2", "avx512"};
+    const int isa = LB_GetKernelIsa();
+    const std::string name = (isa >= 0 && isa < 3) ? names[isa] : "";
+    const int needed = static_cast<int>(name.size()) + 1;
+    if (!buffer || buffer_len <= 0)
+        return needed;
+
+    const int to_copy = std::min(buffer_len - 1, static_cast<int>(name.size()));
+    if (to_copy > 0)
+        std::memcpy(buffer, name.data(), static_cast<size_t>(to_copy));
+    buffer[to_copy] = '\0';
+    return to_copy + 1;
+}
+
+LB_API double LB_CALL LB_GetYearFraction(const char* start_date, const char* end_date, int day_count_conv)
+{
+    clear_error();
+    try
+    {
+        if (!start_date || !end_date) { set_error_a("Null dates passed to LB_GetYearFraction"); return 0.0; }
+        return yearFraction(Date(start_date), Date(end_date), map_ddc(day_count_conv));
+    }
+    catch (const std::exception& e) { set_error_a(std::string("LB_GetYearFraction: ") + e.what()); return 0.0; }
+    catch (...) { set_error_a("Unknown error in LB_GetYearFraction"); return 0.0; }
+}
+
+LB_API int LB_CALL LB_GetLastErrorA(char* buffer, int buffer_len)
+{
+    const int needed = static_cast<int>(g_lastErrorA.size()) + 1;
+    if (!buffer || buffer_len <= 0)
+        return needed;
+
+    const int to_copy = std::min(buffer_len - 1, static_cast<int>(g_lastErrorA.size()));
+    if (to_copy > 0)
+        std::memcpy(buffer, g_lastErrorA.data(), static_cast<size_t>(to_copy));
+    buffer[to_copy] = '\0';
+    return to_copy + 1;
+}
+
+LB_API void LB_CALL LB_ClearLastError()
+{
+    clear_error();
+}
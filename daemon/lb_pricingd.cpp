@@ -0,0 +1,457 @@
+/**
+ * @file lb_pricingd.cpp
+ * @brief Local pricing daemon: one warm `look_back` engine shared over a Unix domain socket.
+ *
+ * @details
+ * Usage: `lb_pricingd [socket_path] [cache_entries]`
+ * (defaults: LB_PRICINGD_SOCKET or /tmp/lookback_pricingd.sock, 65536 entries).
+ *
+ * Each connection is served by its own thread, which only parses frames. All pricing
+ * runs on a single dispatcher thread, whose OpenMP team stays warm across requests and
+ * already spans every core, so concurrent clients never oversubscribe the machine.
+ *
+ * Request coalescing:
+ * - Byte-identical requests that are in flight share one computation.
+ * - Results are cached (the Monte Carlo engine is deterministic for a given request),
+ *   except for time-budgeted requests.
+ * - Monte Carlo price requests queued together on the same contract are merged into a single
+ *   look_back::price_batch() pass.
+ *
+ * Build example:
+ * @code
+ * clang++ -std=c++20 -O3 daemon/lb_pricingd.cpp Look_Back.cpp Look_Back_Kernel.cpp Analytic_Lookback.cpp \
+ *   Heston_Engine.cpp Mc_Checkpoint.cpp Price_Surface.cpp Sample_Store.cpp Tick_Revaluator.cpp Joint_Extrema.cpp Numa_Topology.cpp \
+ *   Concurrency_Governor.cpp Date_Dealing.cpp \
+ *   -I. -Xpreprocessor -fopenmp -lomp -o lb_pricingd
+ * @endcode
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Joint_Extrema.h"
+#include "LB_Protocol.h"
+#include "Look_Back.h"
+#include "Look_Back_Kernel.h"
+#include "Numa_Topology.h"
+
+namespace
+{
+    /// Time the dispatcher waits for more requests to join the current batch.
+    constexpr auto kCoalesceWindow = std::chrono::microseconds(200);
+
+    const char* g_socket_path = nullptr;
+
+    /** @brief Result of one request, as sent back to the client. */
+    struct job_result
+    {
+        std::int32_t status = 0;
+        std::vector<double> values;
+        std::string error;
+    };
+
+    struct job
+    {
+        lbp_request request;
+        std::string key;
+        std::promise<job_result> promise;
+    };
+
+    std::string contract_key(const lbp_contract& c)
+    {
+        return std::string(reinterpret_cast<const char*>(&c), sizeof(c));
+    }
+
+    look_back make_contract(const lbp_contract& c)
+    {
+        // copies guarantee termination even if the client filled all 16 bytes
+        const std::string v(c.value_date, strnlen(c.value_date, sizeof(c.value_date)));
+        const std::string m(c.maturity_date, strnlen(c.maturity_date, sizeof(c.maturity_date)));
+
+        DayCountConv ddc;
+        switch (c.day_count_conv)
+        {
+            case 0:  ddc = DayCountConv::ACT_360; break;
+            case 2:  ddc = DayCountConv::THIRTY_360_US; break;
+            case 3:  ddc = DayCountConv::THIRTY_360_EU; break;
+            case 4:  ddc = DayCountConv::ACT_ACT_ISDA; break;
+            default: ddc = DayCountConv::ACT_365F; break;
+        }
+        look_back lb(c.S0, Date(v), Date(m), c.sigma, c.interest_rate, static_cast<char>(c.option), c.h, ddc);
+        if (c.observed_extremum != 0)
+            lb.set_observed_extremum(c.observed_extremum);
+        if (c.heston_steps > 0)
+            lb.set_heston({c.heston[0], c.heston[1], c.heston[2], c.heston[3], c.heston_steps});
+        if (c.engine > static_cast<std::uint32_t>(pricing_engine::surface))
+            throw Invalid_Parameters("Unknown engine.");
+        if (c.estimator > static_cast<std::uint32_t>(mc_estimator::moment_matched))
+            throw Invalid_Parameters("Unknown estimator.");
+        lb.set_engine(static_cast<pricing_engine>(c.engine));
+        lb.set_estimator(static_cast<mc_estimator>(c.estimator));
+        return lb;
+    }
+
+    /** @brief False for requests whose result depends on timing (never cached). */
+    bool cacheable(const lbp_request& r)
+    {
+        return r.op != LBP_PRICE_WITHIN && !(r.op == LBP_CURVE && r.args[6] > 0);
+    }
+
+    /**
+     * @brief True if price() on this contract runs Monte Carlo (closed-form requests are not batched).
+     * @details Contracts on LB_ENGINE_AUTO that fit the closed form resolve to the analytic engine;
+     * clients reach the batched path with LB_SetEngine(LB_ENGINE_MONTE_CARLO), Heston dynamics or a
+     * contract the closed form does not cover.
+     */
+    bool simulates(const lbp_contract& c)
+    {
+        try { return make_contract(c).active_engine() == pricing_engine::monte_carlo; }
+        catch (...) { return false; }
+    }
+
+    /** @brief Runs one non-batched request. */
+    job_result evaluate(const lbp_request& r)
+    {
+        job_result out;
+
+        // requests that carry no contract
+        if (r.op == LBP_JOINT)
+        {
+            const joint_lookback_prices p = price_joint_lookbacks(r.args[0], r.args[1], r.args[2], r.args[3], r.n,
+                                                                  r.args[4], r.args[5], r.args[6]);
+            out.values = {p.call.price, p.put.price, p.straddle.price, p.range.price,
+                          p.call.se, p.put.se, p.straddle.se, p.range.se};
+            return out;
+        }
+        if (r.op == LBP_INFO)
+        {
+            out.values = {static_cast<double>(numa_topology::instance().nodes()),
+                          static_cast<double>(static_cast<int>(active_kernel_isa()))};
+            return out;
+        }
+
+        const look_back lb = make_contract(r.contract);
+
+        switch (r.op)
+        {
+            case LBP_VALIDATE: break;
+            case LBP_ACTIVE_ENGINE:
+                out.values.push_back(static_cast<double>(static_cast<std::uint32_t>(lb.active_engine())));
+                break;
+            case LBP_PRICE:
+                out.values.push_back(lb.price(r.args[0], r.args[1], r.args[2], r.args[3], r.n));
+                break;
+            case LBP_DELTA: out.values.push_back(lb.delta(r.args[0])); break;
+            case LBP_GAMMA: out.values.push_back(lb.gamma()); break;
+            case LBP_VEGA:  out.values.push_back(lb.vega()); break;
+            case LBP_RHO:   out.values.push_back(lb.rho()); break;
+            case LBP_THETA: out.values.push_back(lb.theta()); break;
+            case LBP_RISK:
+            {
+                const risk_line k = lb.risk_report(r.n);
+                out.values = {k.price, k.delta, k.gamma, k.vega, k.rho, k.theta};
+                break;
+            }
+            case LBP_GRAPH_SIZE:
+                out.values.push_back(static_cast<double>(lb.graphic_size(r.args[0])));
+                break;
+            case LBP_GRAPH_PRICE:
+            case LBP_GRAPH_DELTA:
+            {
+                const std::size_t n = std::min<std::size_t>(lb.graphic_size(r.args[0]), r.n);
+                out.values.resize(2*n);
+                const std::size_t k = (r.op == LBP_GRAPH_PRICE)
+                    ? lb.graphic_price(r.args[0], out.values.data(), out.values.data() + n, n)
+                    : lb.graphic_delta(r.args[0], out.values.data(), out.values.data() + n, n);
+                out.values.resize(2*k);
+                break;
+            }
+            case LBP_ESTIMATE:
+            case LBP_PRICE_WITHIN:
+            case LBP_F32_BIAS:
+            {
+                const mc_estimate e = (r.op == LBP_ESTIMATE)     ? lb.estimate(r.args[0], r.args[1], r.args[2], r.args[3], r.n)
+                                    : (r.op == LBP_PRICE_WITHIN) ? lb.estimate_within(r.args[0], r.args[1], r.args[2], r.args[3], r.args[4])
+                                    : lb.estimate_f32_bias(r.args[0], r.args[1], r.args[2], r.args[3], r.n);
+                out.values = {e.price, e.se, static_cast<double>(e.paths)};
+                break;
+            }
+            case LBP_CURVE:
+            {
+                if (!(r.args[0] >= 0 && r.args[0] <= 2) || !(r.args[1] >= 0 && r.args[1] <= 3)
+                    || !(r.args[4] >= 0) || !(r.args[5] >= 0))
+                    throw Invalid_Parameters("Invalid curve request.");
+                curve_request q{static_cast<curve_axis>(r.args[0]), static_cast<curve_quantity>(r.args[1]), r.args[2], r.args[3]};
+                q.initial_points = static_cast<std::size_t>(r.args[4]);
+                q.max_points = static_cast<std::size_t>(r.args[5]);
+                q.seconds = r.args[6];
+                q.tolerance = r.args[7];
+                q.N = r.n;
+                const std::vector<curve_point> c = lb.sample_curve(q);
+                out.values.resize(3 * c.size());
+                for (std::size_t i = 0; i < c.size(); ++i)
+                {
+                    out.values[i] = c[i].x;
+                    out.values[c.size() + i] = c[i].y;
+                    out.values[2 * c.size() + i] = c[i].se;
+                }
+                break;
+            }
+            default:
+                out.status = 1;
+                out.error = "Unknown operation";
+        }
+        return out;
+    }
+
+    /**
+     * @class coalescing_engine
+     * @brief Deduplicates, caches and batches requests in front of the pricer.
+     */
+    class coalescing_engine
+    {
+    public:
+        explicit coalescing_engine(std::size_t cache_entries) : cache_entries_(cache_entries)
+        {
+            std::thread([this] { dispatch_loop(); }).detach();
+        }
+
+        std::shared_future<job_result> submit(const lbp_request& r)
+        {
+            std::string key(reinterpret_cast<const char*>(&r), sizeof(r));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (auto it = cache_.find(key); it != cache_.end())
+                return it->second;
+            if (auto it = in_flight_.find(key); it != in_flight_.end())
+                return it->second;
+
+            auto j = std::make_unique<job>();
+            j->request = r;
+            j->key = key;
+            std::shared_future<job_result> f = j->promise.get_future().share();
+            in_flight_.emplace(std::move(key), f);
+            queue_.push_back(std::move(j));
+            cv_.notify_one();
+            return f;
+        }
+
+    private:
+        void dispatch_loop()
+        {
+            for (;;)
+            {
+                std::vector<std::unique_ptr<job>> batch;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait(lock, [this] { return !queue_.empty(); });
+                    lock.unlock();
+                    std::this_thread::sleep_for(kCoalesceWindow);
+                    lock.lock();
+                    while (!queue_.empty())
+                    {
+                        batch.push_back(std::move(queue_.front()));
+                        queue_.pop_front();
+                    }
+                }
+                run(batch);
+            }
+        }
+
+        void run(std::vector<std::unique_ptr<job>>& batch)
+        {
+            // Monte Carlo price requests on the same contract share one price_batch() pass
+            std::map<std::string, std::vector<job*>> price_groups;
+            for (auto& j : batch)
+            {
+                if (j->request.op == LBP_PRICE && simulates(j->request.contract))
+                    price_groups[contract_key(j->request.contract)].push_back(j.get());
+                else
+                    complete(*j, guarded([&] { return evaluate(j->request); }));
+            }
+
+            for (auto& [key, jobs] : price_groups)
+            {
+                std::vector<double> prices;
+                const job_result failure = guarded([&] {
+                    std::vector<mc_point> points;
+                    for (job* j : jobs)
+                        points.push_back({j->request.args[0], j->request.args[1], j->request.args[2],
+                                          j->request.args[3], j->request.n});
+                    prices = make_contract(jobs.front()->request.contract).price_batch(points);
+                    return job_result{};
+                });
+
+                for (std::size_t i = 0; i < jobs.size(); ++i)
+                {
+                    if (failure.status != 0)
+                    {
+                        // one bad point must not fail its neighbours: retry individually
+                        complete(*jobs[i], guarded([&] { return evaluate(jobs[i]->request); }));
+                        continue;
+                    }
+                    job_result r;
+                    r.values.push_back(prices[i]);
+                    complete(*jobs[i], r);
+                }
+            }
+        }
+
+        template <class F>
+        static job_result guarded(F&& f)
+        {
+            try { return f(); }
+            catch (const std::exception& e) { return job_result{1, {}, e.what()}; }
+            catch (...) { return job_result{1, {}, "Unknown exception"}; }
+        }
+
+        void complete(job& j, const job_result& r)
+        {
+            j.promise.set_value(r);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = in_flight_.find(j.key);
+            if (r.status == 0 && cache_entries_ > 0 && cacheable(j.request))
+            {
+                if (cache_order_.size() >= cache_entries_)
+                {
+                    cache_.erase(cache_order_.front());
+                    cache_order_.pop_front();
+                }
+                cache_.emplace(j.key, it->second);
+                cache_order_.push_back(j.key);
+            }
+            in_flight_.erase(it);
+        }
+
+        std::size_t cache_entries_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::unique_ptr<job>> queue_;
+        std::unordered_map<std::string, std::shared_future<job_result>> in_flight_;
+        std::unordered_map<std::string, std::shared_future<job_result>> cache_;
+        std::deque<std::string> cache_order_;
+    };
+
+    bool read_all(int fd, void* buf, std::size_t len)
+    {
+        char* p = static_cast<char*>(buf);
+        while (len > 0)
+        {
+            const ssize_t k = ::read(fd, p, len);
+            if (k <= 0)
+                return false;
+            p += k;
+            len -= static_cast<std::size_t>(k);
+        }
+        return true;
+    }
+
+    bool write_all(int fd, const void* buf, std::size_t len)
+    {
+        const char* p = static_cast<const char*>(buf);
+        while (len > 0)
+        {
+            const ssize_t k = ::write(fd, p, len);
+            if (k <= 0)
+                return false;
+            p += k;
+            len -= static_cast<std::size_t>(k);
+        }
+        return true;
+    }
+
+    void serve(int fd, coalescing_engine& engine)
+    {
+        lbp_request req;
+        while (read_all(fd, &req, sizeof(req)))
+        {
+            job_result r;
+            if (req.magic != kLbpMagic || req.version != kLbpVersion)
+                r = job_result{1, {}, "Protocol version mismatch"};
+            else
+                r = engine.submit(req).get();
+
+            const lbp_response_header hdr{kLbpMagic, r.status, static_cast<std::uint32_t>(r.values.size()),
+                                          static_cast<std::uint32_t>(r.error.size())};
+            if (!write_all(fd, &hdr, sizeof(hdr))
+                || !write_all(fd, r.values.data(), r.values.size() * sizeof(double))
+                || !write_all(fd, r.error.data(), r.error.size()))
+                break;
+        }
+        ::close(fd);
+    }
+
+    void on_terminate(int)
+    {
+        if (g_socket_path)
+            ::unlink(g_socket_path);
+        _exit(0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* env = std::getenv("LB_PRICINGD_SOCKET");
+    const std::string path = argc > 1 ? argv[1] : (env ? env : kLbpDefaultSocket);
+    const std::size_t cache_entries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 65536;
+
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        std::cerr << "Socket path too long: " << path << "\n";
+        return 1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(path.c_str());
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listener, 64) != 0)
+    {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    ::chmod(path.c_str(), 0600);
+
+    g_socket_path = path.c_str();
+    std::signal(SIGINT, on_terminate);
+    std::signal(SIGTERM, on_terminate);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    coalescing_engine engine(cache_entries);
+    std::cout << "lb_pricingd listening on " << path << "\n";
+
+    for (;;)
+    {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "accept failed: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        std::thread(serve, fd, std::ref(engine)).detach();
+    }
+}
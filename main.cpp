@@ -43,8 +43,13 @@ int main() {
 
         look_back l(S0, value_date, maturity_date, sigma, r, optType, hBump, DayCountConv::ACT_ACT_ISDA);
 
-        // Pricing & Greeks
-        std::cout << "Price: " << l.price(S0, sigma, r, ttm_actactisd , N) << "\n";
+        // Pricing (with a progress line every 5M paths) & Greeks
+        const auto report = [](void*, const mc_estimate& e) {
+            std::cout << "  ... " << e.paths << " paths: " << e.price << " +/- " << e.se << "\n";
+            return true;
+        };
+        const mc_estimate price = l.estimate_progressive(S0, sigma, r, ttm_actactisd, N, 5000000, report);
+        std::cout << "Price: " << price.price << " (SE " << price.se << ")\n";
         std::cout << "Delta: " << l.delta(S0) << "\n";
         std::cout << "Rho: "   << l.rho()     << "\n";
         std::cout << "Vega: "  << l.vega()    << "\n";
@@ -0,0 +1,151 @@
+/**
+ * @file accuracy_harness.cpp
+ * @brief Accuracy-versus-cost harness of the Monte Carlo estimators against closed-form prices.
+ *
+ * @details
+ * For every estimator and path count, prices a grid of floating-strike contracts
+ * (option type x S x sigma x r x ttm) with `look_back` and compares the result with the
+ * Goldman–Sosin–Gatto closed form. For each configuration it reports:
+ * - bias: mean signed error over the grid (grid points share the engine's substreams, so at
+ *   small path counts this also shows the common sampling noise, not only estimator bias),
+ * - RMSE: root mean squared error,
+ * - mean |error| / SE: should stay around 0.8 if the reported SE is honest,
+ * - total wall time.
+ * Configurations on the error-versus-time Pareto frontier (no other configuration is both
+ * faster and more accurate) are flagged, so the cheapest estimator meeting a tolerance
+ * can be read off directly.
+ *
+ * Usage: `accuracy_harness [--quick]` (output is CSV on stdout).
+ *
+ * Build example:
+ * @code
+ * clang++ -std=c++20 -O3 -I. tools/accuracy_harness.cpp Analytic_Lookback.cpp Look_Back.cpp \
+ *   Look_Back_Kernel.cpp Heston_Engine.cpp Mc_Checkpoint.cpp Price_Surface.cpp Sample_Store.cpp Tick_Revaluator.cpp Numa_Topology.cpp Concurrency_Governor.cpp Date_Dealing.cpp -Xpreprocessor -fopenmp -lomp \
+ *   -o accuracy_harness
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Analytic_Lookback.h"
+#include "Look_Back.h"
+
+namespace
+{
+    /** @brief A Monte Carlo estimator as seen by the harness. */
+    struct estimator_entry
+    {
+        const char* name;
+        std::function<mc_estimate(const look_back&, double S, double sigma, double r, double ttm, unsigned int N)> run;
+    };
+
+    /** @brief Every estimator available in `look_back`. */
+    std::vector<estimator_entry> estimators()
+    {
+        return {
+            {"antithetic", [](const look_back& lb, double S, double sigma, double r, double ttm, unsigned int N) {
+                 return lb.estimate(S, sigma, r, ttm, N);
+             }},
+            {"antithetic_f32", [](const look_back& lb, double S, double sigma, double r, double ttm, unsigned int N) {
+                 look_back f32 = lb;
+                 f32.set_estimator(mc_estimator::antithetic_f32);
+                 return f32.estimate(S, sigma, r, ttm, N);
+             }},
+            {"moment_matched", [](const look_back& lb, double S, double sigma, double r, double ttm, unsigned int N) {
+                 look_back matched = lb;
+                 matched.set_estimator(mc_estimator::moment_matched);
+                 return matched.estimate(S, sigma, r, ttm, N);
+             }},
+        };
+    }
+
+    struct grid_point
+    {
+        char option;
+        double S, sigma, r, ttm;
+        double exact;
+    };
+
+    struct config_result
+    {
+        std::string estimator;
+        unsigned int N;
+        double bias, rmse, z, seconds;
+        bool pareto;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+
+    const std::vector<double> spots = quick ? std::vector<double>{100.0} : std::vector<double>{80.0, 100.0, 120.0};
+    const std::vector<double> sigmas = {0.1, 0.2, 0.4};
+    const std::vector<double> rates = {0.0, 0.02, 0.05};
+    const std::vector<double> ttms = quick ? std::vector<double>{0.5} : std::vector<double>{0.25, 1.0, 2.0};
+    const std::vector<unsigned int> paths = quick ? std::vector<unsigned int>{10000, 100000}
+                                                  : std::vector<unsigned int>{10000, 100000, 1000000, 5000000};
+
+    std::vector<grid_point> grid;
+    for (char option : {'c', 'p'})
+        for (double S : spots)
+            for (double sigma : sigmas)
+                for (double r : rates)
+                    for (double ttm : ttms)
+                        grid.push_back({option, S, sigma, r, ttm, gsg_floating_strike_price(option, S, S, sigma, r, ttm)});
+
+    // only the option type of these instances matters: every price call passes its own market point
+    const Date value_date("01-01-2024"), maturity_date("01-01-2025");
+    const look_back call(100.0, value_date, maturity_date, 0.2, 0.0, 'c', 0.01);
+    const look_back put(100.0, value_date, maturity_date, 0.2, 0.0, 'p', 0.01);
+
+    std::vector<config_result> results;
+    for (const estimator_entry& est : estimators())
+    {
+        for (unsigned int N : paths)
+        {
+            double sum_err = 0.0, sum_sq = 0.0, sum_z = 0.0;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (const grid_point& g : grid)
+            {
+                const mc_estimate e = est.run(g.option == 'c' ? call : put, g.S, g.sigma, g.r, g.ttm, N);
+                const double err = e.price - g.exact;
+                sum_err += err;
+                sum_sq += err * err;
+                sum_z += e.se > 0 ? std::fabs(err) / e.se : 0.0;
+            }
+            const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+
+            const double n = static_cast<double>(grid.size());
+            results.push_back({est.name, N, sum_err / n, std::sqrt(sum_sq / n), sum_z / n, dt.count(), false});
+        }
+    }
+
+    // Pareto frontier: walking by increasing time, keep configurations that lower the RMSE
+    std::vector<config_result*> by_time;
+    for (auto& r : results)
+        by_time.push_back(&r);
+    std::sort(by_time.begin(), by_time.end(), [](const config_result* a, const config_result* b) { return a->seconds < b->seconds; });
+    double best_rmse = INFINITY;
+    for (config_result* r : by_time)
+    {
+        if (r->rmse < best_rmse)
+        {
+            r->pareto = true;
+            best_rmse = r->rmse;
+        }
+    }
+
+    std::printf("estimator,paths,grid_points,bias,rmse,mean_abs_err_over_se,seconds,pareto\n");
+    for (const config_result& r : results)
+        std::printf("%s,%u,%zu,%.6g,%.6g,%.3f,%.4f,%d\n", r.estimator.c_str(), r.N, grid.size(),
+                    r.bias, r.rmse, r.z, r.seconds, r.pareto ? 1 : 0);
+    return 0;
+}
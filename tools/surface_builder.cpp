@@ -0,0 +1,136 @@
+/**
+ * @file surface_builder.cpp
+ * @brief Offline builder of the normalized price surface (see Price_Surface.h).
+ *
+ * @details
+ * Prices a call and a put per point of a uniform grid over a = sigma sqrt(T) and b = r T
+ * (with S = 1, T = 1, sigma = a, r = b) in one look_back::estimate_batch() pass each, and
+ * writes the surface file. The stored error bound is
+ * - 3 x the largest Monte Carlo SE on the grid, plus
+ * - the largest interpolation error, measured at every cell centre on a closed-form twin
+ *   of the grid against the Goldman–Sosin–Gatto price.
+ *
+ * Usage:
+ * @code
+ * surface_builder <out.lbs> [--paths N] [--na n] [--nb n] [--amin x] [--amax x] [--bmax x] [--closed-form]
+ * @endcode
+ * `--closed-form` fills the grid from the closed form instead of simulating (fast, exact
+ * nodes; useful for tests and as a reference).
+ *
+ * Build example:
+ * @code
+ * clang++ -std=c++20 -O3 -I. tools/surface_builder.cpp Price_Surface.cpp Analytic_Lookback.cpp Look_Back.cpp \
+ *   Look_Back_Kernel.cpp Heston_Engine.cpp Mc_Checkpoint.cpp Sample_Store.cpp Tick_Revaluator.cpp Numa_Topology.cpp Concurrency_Governor.cpp \
+ *   Date_Dealing.cpp -Xpreprocessor -fopenmp -lomp -o surface_builder
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Analytic_Lookback.h"
+#include "Look_Back.h"
+#include "Price_Surface.h"
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <out> [--paths N] [--na n] [--nb n] [--amin x] [--amax x] [--bmax x] [--closed-form]\n", argv[0]);
+        return 2;
+    }
+
+    const std::string out = argv[1];
+    surface_grid g{128, 33, 0.02, 1.5, 0.0, 0.4};
+    std::uint64_t N = 5000000;
+    bool closed_form = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--paths") == 0 && has_value)     N = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--na") == 0 && has_value)   g.n_a = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--nb") == 0 && has_value)   g.n_b = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--amin") == 0 && has_value) g.a_min = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--amax") == 0 && has_value) g.a_max = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--bmax") == 0 && has_value) g.b_max = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--closed-form") == 0)        closed_form = true;
+        else { std::fprintf(stderr, "unknown argument '%s'\n", argv[i]); return 2; }
+    }
+    if (g.n_a < 2 || g.n_b < 2 || !(g.a_min > 0) || !(g.a_max > g.a_min) || !(g.b_max > g.b_min) || N == 0)
+    {
+        std::fprintf(stderr, "invalid grid or path count\n");
+        return 2;
+    }
+
+    // only the option type of these instances matters: every point passes its own market data
+    const Date value_date("01-01-2024"), maturity_date("01-01-2025");
+    const look_back contracts[2] = {look_back(1.0, value_date, maturity_date, 0.2, 0.0, 'c', 0.01),
+                                    look_back(1.0, value_date, maturity_date, 0.2, 0.0, 'p', 0.01)};
+
+    std::vector<double> values[2], exact[2];
+    double max_se = 0.0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < 2; ++k)
+    {
+        const char option = k == 0 ? 'c' : 'p';
+        std::vector<mc_point> points;
+        for (std::uint64_t i = 0; i < g.n_a; ++i)
+            for (std::uint64_t j = 0; j < g.n_b; ++j)
+            {
+                points.push_back({1.0, g.a(i), g.b(j), 1.0, N});
+                exact[k].push_back(gsg_floating_strike_price(option, 1.0, 1.0, g.a(i), g.b(j), 1.0));
+            }
+
+        if (closed_form)
+        {
+            values[k] = exact[k];
+            continue;
+        }
+        for (const mc_estimate& e : contracts[k].estimate_batch(points))
+        {
+            values[k].push_back(e.price);
+            max_se = std::max(max_se, e.se);
+        }
+    }
+    const std::chrono::duration<double> build_time = std::chrono::steady_clock::now() - t0;
+
+    // interpolation error of the scheme itself, on exact nodes, at every cell centre
+    double max_interp = 0.0;
+    for (int k = 0; k < 2; ++k)
+        for (std::uint64_t i = 0; i + 1 < g.n_a; ++i)
+            for (std::uint64_t j = 0; j + 1 < g.n_b; ++j)
+            {
+                const double a = 0.5 * (g.a(i) + g.a(i + 1)), b = 0.5 * (g.b(j) + g.b(j + 1));
+                const double f = interpolate_surface(g, exact[k].data(), a, b).f;
+                max_interp = std::max(max_interp, std::fabs(f - gsg_floating_strike_price(k == 0 ? 'c' : 'p', 1.0, 1.0, a, b, 1.0)));
+            }
+
+    const double bound = 3.0 * max_se + max_interp;
+    write_price_surface(out, g, values[0], values[1], bound, closed_form ? 0 : N,
+                        static_cast<std::uint32_t>(mc_estimator::antithetic));
+
+    // lookup cost on the written file
+    const price_surface surface(out);
+    const int lookups = 1000000;
+    double sink = 0.0;
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int q = 0; q < lookups; ++q)
+    {
+        const double a = g.a_min + (g.a_max - g.a_min) * static_cast<double>((q * 7919ULL) % lookups) / lookups;
+        sink += surface.lookup(q & 1 ? 'p' : 'c', a, 0.5 * (g.b_min + g.b_max)).f;
+    }
+    const std::chrono::duration<double> lookup_time = std::chrono::steady_clock::now() - t1;
+
+    std::printf("grid %llux%llu a=[%g,%g] b=[%g,%g] paths=%llu build=%.1fs\n",
+                static_cast<unsigned long long>(g.n_a), static_cast<unsigned long long>(g.n_b),
+                g.a_min, g.a_max, g.b_min, g.b_max, static_cast<unsigned long long>(closed_form ? 0 : N), build_time.count());
+    std::printf("max SE %.3g, interpolation error %.3g, stored bound %.3g (per unit spot)\n", max_se, max_interp, bound);
+    std::printf("lookup %.1f ns (checksum %.6f)\n", 1e9 * lookup_time.count() / lookups, sink / lookups);
+    return 0;
+}